@@ -0,0 +1,105 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/21/23.
+//
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+#include "Silicon/Allocator.hpp"
+#include "Silicon/Async.hpp"
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+#include "Silicon/Types.hpp"
+
+namespace {
+
+constexpr std::size_t TaskCount = 256;
+constexpr std::size_t ContainersPerTask = 1000;
+constexpr std::size_t ElementsPerContainer = 16;
+
+using Clock = std::chrono::steady_clock;
+
+/*
+ * Every task builds many small, short-lived vectors, like the per-frame scratch containers in the renderer.
+ */
+template <typename VectorT>
+void Run(const char *name)
+{
+    std::uint64_t sums[TaskCount] {};
+
+    tf::Taskflow taskflow;
+
+    for (std::size_t task = 0; task < TaskCount; task++) {
+        taskflow.emplace([&sums, task]() {
+            for (std::size_t i = 0; i < ContainersPerTask; i++) {
+                VectorT values;
+
+                for (std::uint64_t j = 0; j < ElementsPerContainer; j++) {
+                    values.push_back(i + j);
+                }
+
+                sums[task] += values.back();
+            }
+        });
+    }
+
+    auto start = Clock::now();
+
+    Si::GetAsyncExecutor().run(taskflow).wait();
+    Si::ResetFrameArenas();
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::uint64_t sum = 0;
+
+    for (std::uint64_t i : sums) {
+        sum += i;
+    }
+
+    Si::Info("{:>14}: {:8.2f} ms (checksum {})", name, seconds * 1000.0, sum);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    for (int run = 0; run < 3; run++) {
+        Run<Si::Vector<std::uint64_t>>("Pool");
+        Run<Si::ThreadLocalVector<std::uint64_t>>("Thread local");
+        Run<Si::FrameVector<std::uint64_t>>("Frame arena");
+    }
+
+    Si::Deinitialize();
+}
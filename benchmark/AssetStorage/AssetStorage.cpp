@@ -0,0 +1,151 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/16/23.
+//
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+#include "Silicon/Asset.hpp"
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+
+namespace {
+
+constexpr std::size_t MiB = 1024 * 1024;
+constexpr std::size_t DefaultPackSize = 1024;
+
+using Clock = std::chrono::steady_clock;
+
+double Milliseconds(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double PeakResidentMiB()
+{
+#if defined(__APPLE__)
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss) / MiB;
+#elif defined(__unix__)
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<double>(usage.ru_maxrss) / 1024;
+#else
+    return 0;
+#endif
+}
+
+class MappedPack : public Si::Asset
+{
+public:
+    explicit MappedPack(std::string path)
+        : Asset(std::move(path), Storage::Mapped)
+    {
+    }
+};
+
+class ReadPack : public Si::Asset
+{
+public:
+    explicit ReadPack(std::string path)
+        : Asset(std::move(path), Storage::Read)
+    {
+    }
+};
+
+template <typename T>
+void Run(const char *name, const std::string &path)
+{
+    auto start = Clock::now();
+    auto pack = Si::Asset::GetNow<T>(path);
+    double loadTime = Milliseconds(start);
+    double loadPeak = PeakResidentMiB();
+
+    start = Clock::now();
+
+    std::uint64_t sum = 0;
+    for (std::uint8_t byte : pack->GetBytes()) {
+        sum += byte;
+    }
+
+    double scanTime = Milliseconds(start);
+
+    Si::Info("{:>6} {:5} MiB: load {:9.2f} ms (peak RSS {:7.1f} MiB), full scan {:9.2f} ms (peak RSS {:7.1f} MiB, checksum {})",
+        name, pack->GetBytes().size() / MiB, loadTime, loadPeak, scanTime, PeakResidentMiB(), sum);
+}
+
+}
+
+/*
+ * Loads one large pack mapped, then read. Peak RSS only ever grows, so the mapped run goes first. Both runs load the pack from the page
+ * cache, as it was just written.
+ *
+ * Usage: AssetStorageBenchmark [pack size in MiB]
+ */
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    std::size_t packSize = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : DefaultPackSize;
+    const std::string path = "AssetStorageBenchmark.pack";
+
+    {
+        std::vector<char> chunk(MiB);
+        for (std::size_t i = 0; i < chunk.size(); i++) {
+            chunk[i] = static_cast<char>(i * 31);
+        }
+
+        std::ofstream pack(path, std::ios::binary);
+        for (std::size_t i = 0; i < packSize; i++) {
+            pack.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        }
+    }
+
+    Si::Info("Baseline peak RSS {:.1f} MiB", PeakResidentMiB());
+
+    Run<MappedPack>("Mapped", path);
+    Run<ReadPack>("Read", "./" + path);
+
+    std::remove(path.c_str());
+
+    Si::Deinitialize();
+}
@@ -0,0 +1,177 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/20/23.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Silicon/Log.hpp"
+#include "Silicon/MeshAsset.hpp"
+#include "Silicon/Silicon.hpp"
+
+namespace {
+
+constexpr std::size_t DefaultGridSize = 1024;
+constexpr int RunCount = 5;
+
+using Clock = std::chrono::steady_clock;
+
+double Milliseconds(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template <typename T>
+void Write(std::ofstream &file, const std::vector<T> &values)
+{
+    file.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+/*
+ * Writes a glTF grid of gridSize by gridSize vertices with positions, colors and 32-bit indices in an external buffer.
+ */
+void WriteGrid(const std::string &gltfPath, const std::string &binPath, std::size_t gridSize)
+{
+    std::vector<float> positions, colors;
+    std::vector<std::uint32_t> indices;
+
+    for (std::size_t y = 0; y < gridSize; y++) {
+        for (std::size_t x = 0; x < gridSize; x++) {
+            positions.insert(positions.end(), {float(x), float(y), 0.0f});
+            colors.insert(colors.end(), {float(x) / gridSize, float(y) / gridSize, 1.0f});
+        }
+    }
+
+    for (std::size_t y = 0; y + 1 < gridSize; y++) {
+        for (std::size_t x = 0; x + 1 < gridSize; x++) {
+            auto i = static_cast<std::uint32_t>(y * gridSize + x);
+            auto below = static_cast<std::uint32_t>(i + gridSize);
+            indices.insert(indices.end(), {i, i + 1, below, below, i + 1, below + 1});
+        }
+    }
+
+    std::ofstream bin(binPath, std::ios::binary);
+    Write(bin, positions);
+    Write(bin, colors);
+    Write(bin, indices);
+
+    std::size_t positionBytes = positions.size() * sizeof(float);
+    std::size_t colorBytes = colors.size() * sizeof(float);
+    std::size_t indexBytes = indices.size() * sizeof(std::uint32_t);
+    std::size_t vertexCount = gridSize * gridSize;
+
+    std::ofstream(gltfPath) << R"({
+    "asset": {"version": "2.0"},
+    "buffers": [{"byteLength": )" << positionBytes + colorBytes + indexBytes << R"(, "uri": ")" << binPath << R"("}],
+    "bufferViews": [
+        {"buffer": 0, "byteOffset": 0, "byteLength": )" << positionBytes << R"(},
+        {"buffer": 0, "byteOffset": )" << positionBytes << R"(, "byteLength": )" << colorBytes << R"(},
+        {"buffer": 0, "byteOffset": )" << positionBytes + colorBytes << R"(, "byteLength": )" << indexBytes << R"(}
+    ],
+    "accessors": [
+        {"bufferView": 0, "componentType": 5126, "count": )" << vertexCount << R"(, "type": "VEC3"},
+        {"bufferView": 1, "componentType": 5126, "count": )" << vertexCount << R"(, "type": "VEC3"},
+        {"bufferView": 2, "componentType": 5125, "count": )" << indices.size() << R"(, "type": "SCALAR"}
+    ],
+    "meshes": [{"name": "Grid", "primitives": [{"attributes": {"POSITION": 0, "COLOR_0": 1}, "indices": 2}]}]
+})";
+}
+
+/*
+ * Loads a mesh and copies its staging buffer to memory standing in for a mapped Vulkan::Buffer.
+ */
+double Load(const std::string &path, std::unique_ptr<std::uint8_t[]> &upload)
+{
+    auto start = Clock::now();
+
+    auto mesh = Si::Asset::GetNow<Si::MeshAsset>(path);
+    auto staging = mesh->GetStagingBuffer();
+    std::copy(staging.begin(), staging.end(), upload.get());
+
+    return Milliseconds(start);
+}
+
+}
+
+/*
+ * Usage: MeshCookingBenchmark [grid size]
+ */
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    std::size_t gridSize = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : DefaultGridSize;
+
+    const std::string gltfPath = "MeshCookingBenchmark.gltf";
+    const std::string binPath = "MeshCookingBenchmark.bin";
+    const std::string cookedPath = "MeshCookingBenchmark.simesh";
+
+    WriteGrid(gltfPath, binPath, gridSize);
+
+    std::size_t stagingSize;
+    {
+        auto mesh = Si::Asset::GetNow<Si::MeshAsset>(gltfPath);
+        mesh->Cook(cookedPath);
+        stagingSize = mesh->GetStagingBuffer().size();
+    }
+
+    // Every load should come from disk, not the cache.
+    Si::Asset::SetCacheBudget(0);
+
+    auto upload = std::make_unique<std::uint8_t[]>(stagingSize);
+
+    for (const auto &[name, path] : {std::pair {"glTF", gltfPath}, std::pair {"Cooked", cookedPath}}) {
+        double best = 0, total = 0;
+
+        for (int run = 0; run < RunCount; run++) {
+            double time = Load(path, upload);
+            best = run ? std::min(best, time) : time;
+            total += time;
+        }
+
+        Si::Info("{:>6} {}x{} grid ({:.1f} MiB staging): best {:9.2f} ms, mean {:9.2f} ms", name, gridSize, gridSize,
+            stagingSize / (1024.0 * 1024.0), best, total / RunCount);
+    }
+
+    std::remove(gltfPath.c_str());
+    std::remove(binPath.c_str());
+    std::remove(cookedPath.c_str());
+
+    Si::Deinitialize();
+}
@@ -0,0 +1,168 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/9/23.
+//
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+#include "Silicon/Log.hpp"
+#include "Silicon/Node.hpp"
+#include "Silicon/Silicon.hpp"
+#include "Silicon/Types.hpp"
+
+namespace {
+
+constexpr std::size_t FanOut = 8;
+
+// Tearing down the legacy graph is quadratic, so it is only timed up to this many nodes.
+constexpr std::size_t MaxLegacyDestroyCount = 100000;
+
+using Clock = std::chrono::steady_clock;
+
+double Milliseconds(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/*
+ * The node graph as it was before NodeHierarchy, kept here as a baseline.
+ */
+class LegacyNode
+{
+public:
+    using Graph = Si::Graph<Si::NotNull<LegacyNode *>, Si::GraphList>;
+
+    LegacyNode()
+        : m_descriptor(boost::add_vertex(Si::NotNull<LegacyNode *>(this), s_graph))
+    {
+    }
+
+    void addChild(LegacyNode &node)
+    {
+        boost::add_edge(m_descriptor, node.m_descriptor, s_graph);
+    }
+
+    template <typename F>
+    void traverse(F &f)
+    {
+        f(*this);
+
+        auto [begin, end] = boost::adjacent_vertices(m_descriptor, s_graph);
+
+        for (auto i = begin; i != end; ++i) {
+            s_graph[*i]->traverse(f);
+        }
+    }
+
+    ~LegacyNode()
+    {
+        boost::clear_vertex(m_descriptor, s_graph);
+        boost::remove_vertex(m_descriptor, s_graph);
+    }
+
+    std::uint64_t value = 1;
+
+private:
+    Graph::vertex_descriptor m_descriptor;
+
+    static Graph &s_graph;
+};
+
+// Leaked on purpose, tearing down the graph at exit has the same quadratic cost as destroying the nodes.
+LegacyNode::Graph &LegacyNode::s_graph = *new LegacyNode::Graph;
+
+class BenchmarkNode : public Si::Node
+{
+public:
+    std::uint64_t value = 1;
+};
+
+template <typename T, typename Traverse>
+void Run(const char *name, std::size_t count, bool destroy, Traverse traverse)
+{
+    auto start = Clock::now();
+
+    auto nodes = std::make_unique<T[]>(count);
+
+    for (std::size_t i = 1; i < count; i++) {
+        nodes[(i - 1) / FanOut].addChild(nodes[i]);
+    }
+
+    double buildTime = Milliseconds(start);
+
+    std::uint64_t sum = 0;
+    start = Clock::now();
+    traverse(nodes[0], sum);
+    double firstTraversalTime = Milliseconds(start);
+
+    start = Clock::now();
+    traverse(nodes[0], sum);
+    double traversalTime = Milliseconds(start);
+
+    if (!destroy) {
+        // Intentionally leaked so the graph never refers to freed nodes.
+        nodes.release();
+
+        Si::Info("{:>14} {:>9} nodes: build {:9.2f} ms, first traversal {:9.2f} ms, traversal {:9.2f} ms, destroy   skipped    (checksum {})",
+            name, count, buildTime, firstTraversalTime, traversalTime, sum);
+        return;
+    }
+
+    start = Clock::now();
+    nodes.reset();
+    double destroyTime = Milliseconds(start);
+
+    Si::Info("{:>14} {:>9} nodes: build {:9.2f} ms, first traversal {:9.2f} ms, traversal {:9.2f} ms, destroy {:9.2f} ms (checksum {})",
+        name, count, buildTime, firstTraversalTime, traversalTime, destroyTime, sum);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    for (std::size_t count : {10'000, 100'000, 1'000'000}) {
+        Run<LegacyNode>("Legacy graph", count, count <= MaxLegacyDestroyCount, [](LegacyNode &root, std::uint64_t &sum) {
+            auto visit = [&sum](LegacyNode &node) { sum += node.value; };
+            root.traverse(visit);
+        });
+
+        Run<BenchmarkNode>("NodeHierarchy", count, true, [](BenchmarkNode &root, std::uint64_t &sum) {
+            root.traverse([&sum](Si::Node &node) { sum += static_cast<BenchmarkNode &>(node).value; });
+        });
+    }
+
+    Si::Deinitialize();
+}
@@ -0,0 +1,175 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/14/23.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Silicon/Event.hpp"
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+
+namespace {
+
+// Every run makes this many callbacks in total, whatever the subscriber count.
+constexpr std::size_t CallbacksPerRun = 10'000'000;
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchmarkEvent {
+    std::uint64_t value;
+};
+
+/*
+ * The subscriber registry as it was before SubscriberList and Delegate: a vector of subscribers, found by a linear search on removal,
+ * each calling through std::function. Kept here as the baseline both changes are measured against.
+ */
+template <typename T>
+class BaselineSub
+{
+public:
+    explicit BaselineSub(std::function<void(const T &)> func)
+        : m_func(std::move(func))
+    {
+        Subscribers.push_back(Si::NotNull<BaselineSub<T> *>(this));
+    }
+
+    ~BaselineSub()
+    {
+        auto i = std::find(Subscribers.begin(), Subscribers.end(), this);
+
+        if (i != Subscribers.end()) {
+            Subscribers.erase(i);
+        }
+    }
+
+    static void Pub(const T &data)
+    {
+        for (BaselineSub<T> *i : Subscribers) {
+            i->m_func(data);
+        }
+    }
+
+private:
+    inline static std::vector<Si::NotNull<BaselineSub<T> *>> Subscribers;
+
+    std::function<void(const T &)> m_func;
+};
+
+/*
+ * A subscriber calling through std::function on the same SubscriberList as Si::Sub. Against Si::Sub it isolates the cost of Delegate
+ * alone, and against the baseline the cost of the subscriber list alone.
+ */
+template <typename T>
+class FunctionSub
+{
+public:
+    explicit FunctionSub(std::function<void(const T &)> func)
+        : m_func(std::move(func))
+        , m_slot(GetSubscribers().add(Si::NotNull<FunctionSub<T> *>(this)))
+    {
+    }
+
+    ~FunctionSub()
+    {
+        GetSubscribers().remove(m_slot);
+    }
+
+    static void Pub(const T &data)
+    {
+        GetSubscribers().forEach([&data](FunctionSub<T> &i) {
+            i.m_func(data);
+        });
+    }
+
+private:
+    static Si::Event::SubscriberList<FunctionSub<T>> &GetSubscribers()
+    {
+        static Si::Event::SubscriberList<FunctionSub<T>> subscribers;
+        return subscribers;
+    }
+
+    std::function<void(const T &)> m_func;
+    typename Si::Event::SubscriberList<FunctionSub<T>>::Slot m_slot;
+};
+
+template <typename S, typename Publish>
+void Run(const char *name, std::size_t subscriberCount, Publish publish)
+{
+    std::uint64_t sum = 0;
+    std::vector<std::unique_ptr<S>> subs;
+
+    for (std::size_t i = 0; i < subscriberCount; i++) {
+        subs.push_back(std::make_unique<S>([&sum](const BenchmarkEvent &event) { sum += event.value; }));
+    }
+
+    std::size_t publishCount = CallbacksPerRun / subscriberCount;
+
+    auto start = Clock::now();
+
+    for (std::size_t i = 0; i < publishCount; i++) {
+        publish(BenchmarkEvent { i });
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    Si::Info("{:>14} {:>5} subscribers: {:12.0f} events/s, {:12.0f} callbacks/s (checksum {})",
+        name, subscriberCount, publishCount / seconds, publishCount * subscriberCount / seconds, sum);
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    for (std::size_t count : {1, 10, 1000}) {
+        Run<BaselineSub<BenchmarkEvent>>("baseline", count, [](const BenchmarkEvent &event) {
+            BaselineSub<BenchmarkEvent>::Pub(event);
+        });
+
+        Run<FunctionSub<BenchmarkEvent>>("std::function", count, [](const BenchmarkEvent &event) {
+            FunctionSub<BenchmarkEvent>::Pub(event);
+        });
+
+        Run<Si::Sub<BenchmarkEvent>>("Delegate", count, [](const BenchmarkEvent &event) {
+            Si::Pub(event);
+        });
+    }
+
+    Si::Deinitialize();
+}
@@ -0,0 +1,8 @@
+function(AddSiliconBenchmark BENCHMARK_NAME)
+    add_executable(${BENCHMARK_NAME}Benchmark benchmark/${BENCHMARK_NAME}/${BENCHMARK_NAME}.cpp)
+    target_link_libraries(${BENCHMARK_NAME}Benchmark Silicon)
+
+    if (SI_PLATFORM STREQUAL "Web")
+        target_link_options(${BENCHMARK_NAME}Benchmark PRIVATE "--emrun")
+    endif()
+endfunction()
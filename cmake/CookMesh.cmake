@@ -0,0 +1,8 @@
+function(CookMesh PATH)
+    add_custom_command(
+            COMMAND SiliconMeshCooker ${PATH} ${CMAKE_CURRENT_BINARY_DIR}/${PATH}.simesh
+            OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/${PATH}.simesh
+            DEPENDS SiliconMeshCooker ${PATH}
+            WORKING_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}
+    )
+endfunction()
@@ -0,0 +1,14 @@
+function(PackAssets ARCHIVE)
+    cmake_parse_arguments(PACK "COMPRESS" "" "FILES" ${ARGN})
+
+    if (PACK_COMPRESS)
+        set(PACK_FLAGS --compress)
+    endif()
+
+    add_custom_command(
+            COMMAND SiliconPacker ${PACK_FLAGS} ${CMAKE_CURRENT_BINARY_DIR}/${ARCHIVE} ${PACK_FILES}
+            OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/${ARCHIVE}
+            DEPENDS SiliconPacker ${PACK_FILES}
+            WORKING_DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}
+    )
+endfunction()
@@ -31,11 +31,270 @@
 #ifndef SILICON_ALLOCATOR_HPP
 #define SILICON_ALLOCATOR_HPP
 
+#include <cstddef>
+#include <new>
+
 #include "boost/pool/pool_alloc.hpp"
 
+#include "MemoryTracking.hpp"
+
 namespace Si {
+
+/**
+ * General purpose allocator for long-lived data. Allocations come from boost's pools and are accounted to a tag.
+ *
+ * @tparam T The type to allocate.
+ * @tparam Tag The subsystem the allocations are accounted to.
+ */
+template <typename T, MemoryTag Tag = MemoryTag::General>
+class Allocator : public boost::pool_allocator<T> {
+public:
+    using Base = boost::pool_allocator<T>;
+    using typename Base::pointer;
+    using typename Base::size_type;
+
+    template <typename U>
+    struct rebind {
+        using other = Allocator<U, Tag>;
+    };
+
+    Allocator() = default;
+
+    template <typename U>
+    Allocator(const Allocator<U, Tag> &) noexcept
+    {
+    }
+
+    static pointer allocate(size_type n)
+    {
+        pointer allocation = Base::allocate(n);
+        TrackAllocation(Tag, n * sizeof(T));
+        return allocation;
+    }
+
+    static pointer allocate(size_type n, const void *)
+    {
+        return allocate(n);
+    }
+
+    static void deallocate(pointer allocation, size_type n)
+    {
+        TrackDeallocation(Tag, n * sizeof(T));
+        Base::deallocate(allocation, n);
+    }
+};
+
+template <typename T, typename U, MemoryTag Tag>
+bool operator==(const Allocator<T, Tag> &, const Allocator<U, Tag> &) noexcept
+{
+    return true;
+}
+
+template <typename T, typename U, MemoryTag Tag>
+bool operator!=(const Allocator<T, Tag> &, const Allocator<U, Tag> &) noexcept
+{
+    return false;
+}
+
+/**
+ * A linear allocator that hands out memory by bumping an offset into large blocks. Individual allocations are never
+ * freed; everything is released at once by Reset(). An Arena is not thread-safe.
+ */
+class Arena {
+public:
+    static constexpr std::size_t DefaultBlockSize = 64 * 1024;
+
+    explicit Arena(std::size_t blockSize = DefaultBlockSize);
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena();
+
+    /**
+     * Allocates memory from the arena.
+     *
+     * @param size The number of bytes to allocate.
+     * @param alignment The alignment of the allocation. Must be a power of two.
+     * @return A pointer to the allocated memory.
+     */
+    void *Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * Makes all the memory handed out by the arena available again. Blocks are kept for reuse.
+     */
+    void Reset();
+
+    /**
+     * @return The number of bytes handed out since the last reset.
+     */
+    std::size_t GetUsed() const;
+
+    /**
+     * @return The number of bytes reserved by the arena.
+     */
+    std::size_t GetCapacity() const;
+
+private:
+    struct Block;
+
+    Block *m_blocks = nullptr;
+    Block *m_current = nullptr;
+    std::size_t m_offset = 0;
+    std::size_t m_used = 0;
+    std::size_t m_blockSize;
+};
+
+/**
+ * Gets the calling thread's frame arena. Memory allocated from it is valid until the end of the current Si::Loop()
+ * iteration.
+ *
+ * @return The calling thread's frame arena.
+ */
+Arena &GetFrameArena();
+
+/**
+ * Resets the frame arena of every thread. Called by Si::Loop() at the end of each frame, when no other thread may be
+ * using its frame arena.
+ */
+void ResetFrameArenas();
+
+/**
+ * Allocates and frees fixed size blocks from free lists owned by the calling thread, so no lock is taken. Memory is
+ * kept for reuse and is never returned to the OS. Blocks may be freed on any thread.
+ *
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory, aligned to alignof(std::max_align_t).
+ */
+void *ThreadLocalAllocate(std::size_t size);
+
+/**
+ * Frees memory allocated by ThreadLocalAllocate().
+ *
+ * @param pointer The pointer returned by ThreadLocalAllocate().
+ * @param size The size passed to ThreadLocalAllocate().
+ */
+void ThreadLocalFree(void *pointer, std::size_t size);
+
+/**
+ * STL allocator that allocates from an Arena. Deallocation does nothing; the memory is reclaimed when the arena is
+ * reset.
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena &arena) noexcept
+        : m_arena(&arena)
+    {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept
+        : m_arena(other.getArena())
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(m_arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, std::size_t) noexcept { }
+
+    Arena *getArena() const noexcept { return m_arena; }
+
+private:
+    Arena *m_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) noexcept
+{
+    return lhs.getArena() == rhs.getArena();
+}
+
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T> &lhs, const ArenaAllocator<U> &rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+/**
+ * STL allocator that allocates from the calling thread's frame arena. Containers using it must not outlive the
+ * current frame.
+ */
 template <typename T>
-using Allocator = boost::pool_allocator<T>;
+class FrameAllocator {
+public:
+    using value_type = T;
+
+    FrameAllocator() noexcept = default;
+
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U> &) noexcept
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(GetFrameArena().Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *, std::size_t) noexcept { }
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T> &, const FrameAllocator<U> &) noexcept
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T> &, const FrameAllocator<U> &) noexcept
+{
+    return false;
+}
+
+/**
+ * STL allocator for containers owned by worker tasks. Allocations never take a lock.
+ */
+template <typename T>
+class ThreadLocalAllocator {
+public:
+    using value_type = T;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+
+    ThreadLocalAllocator() noexcept = default;
+
+    template <typename U>
+    ThreadLocalAllocator(const ThreadLocalAllocator<U> &) noexcept
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(ThreadLocalAllocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *pointer, std::size_t n) noexcept
+    {
+        ThreadLocalFree(pointer, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const ThreadLocalAllocator<T> &, const ThreadLocalAllocator<U> &) noexcept
+{
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const ThreadLocalAllocator<T> &, const ThreadLocalAllocator<U> &) noexcept
+{
+    return false;
+}
+
 }
 
 #endif // SILICON_ALLOCATOR_HPP
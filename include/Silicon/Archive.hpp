@@ -0,0 +1,179 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/17/23.
+//
+
+#ifndef SILICON_ARCHIVE_HPP
+#define SILICON_ARCHIVE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "Silicon/Asset.hpp"
+#include "Silicon/Types.hpp"
+
+namespace Si {
+
+/**
+ * A packed archive of assets: a single file holding a hashed path table and the assets' contents.
+ *
+ * Once mounted, Asset resolves paths through the archive before falling back to the filesystem, so loading an archived asset costs no
+ * filesystem calls. Uncompressed entries are served straight from the archive's mapping.
+ *
+ * The layout, all little-endian:
+ *  - Header
+ *  - Entry table, a power of two number of slots addressed by path hash with linear probing
+ *  - Path strings
+ *  - Entry contents, each aligned to Archive::Alignment
+ */
+class Archive : public Asset
+{
+public:
+    static constexpr std::uint32_t Magic = 0x4b504953; // "SIPK"
+    static constexpr std::uint32_t Version = 1;
+    static constexpr std::uint64_t Alignment = 64;
+
+    enum class Compression : std::uint32_t
+    {
+        None,
+        /// A byte-oriented LZ77 encoding in the style of LZ4, cheap enough to decode on the load path.
+        LZ
+    };
+
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t entryCount;
+        std::uint32_t slotCount;
+        std::uint64_t tableOffset;
+        std::uint64_t stringsOffset;
+    };
+
+    struct Entry {
+        std::uint64_t pathHash;
+        std::uint64_t offset;
+        std::uint64_t size;
+        std::uint64_t originalSize;
+        std::uint32_t pathOffset;
+        std::uint32_t pathLength;
+        Compression compression;
+        std::uint32_t reserved;
+    };
+
+    explicit Archive(std::string path);
+
+    /**
+     * Looks up an entry by the path it was packed under.
+     *
+     * @param path The path of the asset.
+     * @return The entry, or nullptr if the archive does not contain the path.
+     */
+    [[nodiscard]] const Entry *Find(std::string_view path) const;
+
+    /**
+     * @return The entry's contents as stored, compressed if the entry is.
+     */
+    [[nodiscard]] Span<const std::uint8_t> GetStoredBytes(const Entry &entry) const;
+
+    /**
+     * Decompresses an entry.
+     *
+     * @param entry The entry to decompress.
+     * @param out Where to put the contents, resized to the entry's original size.
+     */
+    void Extract(const Entry &entry, Tagged<MemoryTag::Assets>::Vector<std::uint8_t> &out) const;
+
+    [[nodiscard]] std::string_view GetEntryPath(const Entry &entry) const;
+    [[nodiscard]] std::size_t GetEntryCount() const;
+
+    /**
+     * Mounts an archive. Archives mounted later take precedence over earlier ones.
+     *
+     * @param path The path of the archive.
+     * @return The archive.
+     */
+    static std::shared_ptr<Archive> Mount(const std::string &path);
+
+    static void Unmount(const std::string &path);
+
+    /**
+     * Finds the most recently mounted archive that contains a path.
+     *
+     * @param path The path of the asset.
+     * @param entry Set to the entry in the returned archive.
+     * @return The archive, or nullptr if no mounted archive contains the path.
+     */
+    static std::shared_ptr<const Archive> Resolve(std::string_view path, const Entry *&entry);
+
+    static std::uint64_t Hash(std::string_view path);
+
+private:
+    Span<const Entry> m_entries;
+    std::string_view m_strings;
+};
+
+/**
+ * Builds an archive. Used by the packer tool at build time.
+ */
+class ArchiveWriter
+{
+public:
+    /**
+     * Adds an asset. Entries that would not shrink by compressing are stored uncompressed.
+     *
+     * @param path The path to pack the asset under.
+     * @param bytes The asset's contents.
+     * @param compression How to compress the asset.
+     */
+    void Add(std::string path, Span<const std::uint8_t> bytes, Archive::Compression compression = Archive::Compression::None);
+
+    /**
+     * Writes the archive to disk.
+     *
+     * @param path Where to write the archive.
+     * @return Whether the archive was written.
+     */
+    bool Write(const std::string &path) const;
+
+private:
+    struct PendingEntry {
+        std::string path;
+        Vector<std::uint8_t> bytes;
+        std::uint64_t originalSize;
+        Archive::Compression compression;
+    };
+
+    Vector<PendingEntry> m_entries;
+};
+
+}
+
+#endif // SILICON_ARCHIVE_HPP
@@ -34,71 +34,250 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <string_view>
+
+#include "boost/assert.hpp"
 
-#include "Silicon/Async.hpp"
 #include "Silicon/Log.hpp"
 #include "Silicon/Types.hpp"
 
 namespace Si {
 
+class Archive;
+
 class Asset
 {
+    struct Load;
+    struct Streamer;
+
+    using Loader = std::shared_ptr<Asset> (*)(const std::string &);
+
 public:
+    /**
+     * How an asset's bytes are held in memory.
+     */
+    enum class Storage
+    {
+        /// The file is memory-mapped read-only, so nothing is read or copied until the bytes are touched. Uncompressed assets in a mounted
+        /// Archive view the archive's mapping. Falls back to Read on platforms without memory mapping.
+        Mapped,
+        /// The whole file is read into memory when the asset loads.
+        Read
+    };
+
+    /**
+     * The order in which queued loads are serviced. Loads of equal priority are serviced in the order they were requested.
+     */
+    enum class Priority
+    {
+        Low,
+        Normal,
+        High,
+        Critical
+    };
+
+    /**
+     * Counters for the asset cache.
+     */
+    struct CacheStats {
+        /// Requests served by a loaded or in-flight asset.
+        std::uint64_t hits;
+        /// Requests that started a load.
+        std::uint64_t misses;
+        /// Assets dropped from the cache to stay within the budget.
+        std::uint64_t evictions;
+        /// The size of the assets the cache keeps resident, by Asset::GetResidentSize().
+        std::size_t residentBytes;
+        std::size_t residentCount;
+        std::size_t budget;
+    };
+
+    /**
+     * A pending asset load returned by Asset::Get().
+     *
+     * Every request for the same path shares a single load. Dropping a request does not cancel it, so it can be used to prefetch.
+     *
+     * @tparam T The type of asset being loaded.
+     */
     template <typename T>
-    static std::shared_ptr<T> GetNow(const std::string &asset_path)
+    class Request
     {
-        if (auto asset = s_loadedAssets.find(asset_path); asset != s_loadedAssets.end())
+    public:
+        Request() = default;
+
+        Request(const Request &) = delete;
+        Request &operator=(const Request &) = delete;
+
+        Request(Request &&) noexcept = default;
+        Request &operator=(Request &&) noexcept = default;
+
+        /**
+         * Waits for the load to finish. The request must be valid.
+         * @return The asset, or nullptr if the request was cancelled. Rethrows any exception thrown while loading.
+         */
+        std::shared_ptr<T> get() const
         {
-            if (auto asset_ptr = asset->second.lock())
-            {
-                return std::static_pointer_cast<T>(asset_ptr);
-            }
-            else
-            {
-                Engine::Trace("Cache miss for asset: {}", asset_path);
+            BOOST_ASSERT_MSG(m_load, "Request is empty, it was default constructed or moved from");
+            return std::static_pointer_cast<T>(Wait(*m_load));
+        }
+
+        /**
+         * Blocks until the asset has loaded or the load was cancelled. The request must be valid.
+         */
+        void wait() const
+        {
+            BOOST_ASSERT_MSG(m_load, "Request is empty, it was default constructed or moved from");
+            Wait(*m_load);
+        }
+
+        /**
+         * The request must be valid.
+         * @return Whether get() would return without blocking.
+         */
+        [[nodiscard]] bool isReady() const
+        {
+            BOOST_ASSERT_MSG(m_load, "Request is empty, it was default constructed or moved from");
+            return IsReady(*m_load);
+        }
+
+        /**
+         * Withdraws this request. The load is only cancelled once every request for the path has been withdrawn, and only if it has not
+         * started yet, in which case get() returns nullptr.
+         */
+        void cancel()
+        {
+            if (m_load && !m_cancelled) {
+                m_cancelled = true;
+                Cancel(*m_load);
             }
         }
 
-        auto asset = std::make_shared<T>(asset_path);
-        s_loadedAssets[asset_path] = asset;
-        return asset;
+        [[nodiscard]] bool isValid() const
+        {
+            return m_load != nullptr;
+        }
+
+    private:
+        friend class Asset;
+
+        explicit Request(std::shared_ptr<Load> load)
+            : m_load(std::move(load))
+        {
+        }
+
+        std::shared_ptr<Load> m_load;
+        bool m_cancelled = false;
+    };
+
+    /**
+     * Loads an asset on the calling thread, unless it is already loaded or another thread is loading it.
+     *
+     * @tparam T The type of asset to load.
+     * @param asset_path The path of the asset.
+     * @return The asset.
+     */
+    template <typename T>
+    static std::shared_ptr<T> GetNow(const std::string &asset_path)
+    {
+        return std::static_pointer_cast<T>(LoadNow(asset_path, &Construct<T>));
     }
 
+    /**
+     * Queues an asset to be loaded on the I/O threads. Loads already in flight for the same path are shared, and their priority is raised
+     * if this request's is higher.
+     *
+     * @tparam T The type of asset to load.
+     * @param asset_path The path of the asset.
+     * @param priority The priority of the load relative to other queued loads.
+     * @return A request that can be waited on or cancelled.
+     */
     template <typename T>
-    static Future<std::shared_ptr<T>> Get(const std::string &asset_path)
+    static Request<T> Get(const std::string &asset_path, Priority priority = Priority::Normal)
     {
-        return Async<std::shared_ptr<T>>([asset_path]() {
-            return GetNow<T>(asset_path);
-        });
+        return Request<T>(Enqueue(asset_path, &Construct<T>, priority));
     }
 
+    /**
+     * @return The number of loads queued or in progress.
+     */
+    static std::size_t GetPendingCount();
+
+    /**
+     * Cancels every queued load, releases every cached asset, and stops the I/O threads. The threads are restarted by the next call to
+     * Get().
+     */
+    static void Shutdown();
+
+    static CacheStats GetCacheStats();
+
+    /**
+     * Sets how many bytes of recently used assets the cache keeps resident after their last user releases them. Assets are evicted in
+     * least recently used order.
+     *
+     * @param bytes The budget in bytes, measured by Asset::GetResidentSize().
+     */
+    static void SetCacheBudget(std::size_t bytes);
+
     [[nodiscard]] const std::string &GetPath() const;
-    Vector<std::uint8_t> &GetBytes();
+
+    /**
+     * @return The contents of the asset's file. Valid for as long as the asset is.
+     */
+    [[nodiscard]] Span<const std::uint8_t> GetBytes() const;
+
+    [[nodiscard]] Storage GetStorage() const;
+
+    /**
+     * @return How much memory the asset holds on to, counted against the cache budget. Defaults to the size of its bytes.
+     */
+    [[nodiscard]] virtual std::size_t GetResidentSize() const;
+
+    // An asset owns its mapping and its bytes may point into its own data, so a copy would unmap twice or view freed memory.
+    Asset(const Asset &) = delete;
+    Asset &operator=(const Asset &) = delete;
 
     virtual ~Asset();
 
 protected:
-    explicit Asset(std::string path);
-
-    Vector<std::uint8_t> m_data;
+    explicit Asset(std::string path, Storage storage = Storage::Mapped);
 
 private:
-    std::string m_path;
+    bool loadArchived(Storage storage);
+    bool map();
+    void read();
+
+    template <typename T>
+    static std::shared_ptr<Asset> Construct(const std::string &asset_path)
+    {
+        return std::make_shared<T>(asset_path);
+    }
+
+    static Streamer &GetStreamer();
 
-    static Si::HashMap<std::string, std::weak_ptr<Si::Asset>> s_loadedAssets;
+    static std::shared_ptr<Asset> LoadNow(const std::string &asset_path, Loader loader);
+    static std::shared_ptr<Load> Enqueue(const std::string &asset_path, Loader loader, Priority priority);
 
+    static std::shared_ptr<Asset> Wait(Load &load);
+    static bool IsReady(Load &load);
+    static void Cancel(Load &load);
+
+    std::string m_path;
+
+    Tagged<MemoryTag::Assets>::Vector<std::uint8_t> m_data;
+    void *m_mapping = nullptr;
+    std::shared_ptr<const Archive> m_archive;
+    Span<const std::uint8_t> m_bytes;
 };
 
 class PlainTextAsset : public Asset
 {
 public:
-    explicit PlainTextAsset(std::string path);
-
-    [[nodiscard]] const std::string &GetText() const;
-
-private:
-    std::string m_text;
+    explicit PlainTextAsset(std::string path, Storage storage = Storage::Mapped);
 
+    /**
+     * @return The text, viewing the asset's bytes directly.
+     */
+    [[nodiscard]] std::string_view GetText() const;
 };
 
 }
@@ -0,0 +1,205 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/14/23.
+//
+
+#ifndef SILICON_DELEGATE_HPP
+#define SILICON_DELEGATE_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "boost/assert.hpp"
+
+namespace Si {
+
+template <typename Signature, std::size_t Capacity = 4 * sizeof(void *)>
+class Delegate;
+
+/**
+ * A callable wrapper with fixed inline storage.
+ *
+ * Unlike std::function, a Delegate never allocates: the callable is stored inside the Delegate itself, and callables that do not fit
+ * are rejected at compile time. Member functions can be bound to an object with Bind().
+ *
+ * @tparam R The return type.
+ * @tparam Args The argument types.
+ * @tparam Capacity The number of bytes available to store the callable.
+ */
+template <typename R, typename... Args, std::size_t Capacity>
+class Delegate<R(Args...), Capacity>
+{
+public:
+    Delegate() = default;
+
+    Delegate(std::nullptr_t) { }
+
+    /**
+     * Creates a delegate from any copyable callable that fits in the inline storage.
+     *
+     * @param f The callable to store.
+     */
+    template <typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Delegate> && std::is_invocable_r_v<R, std::decay_t<F> &, Args...>>>
+    Delegate(F &&f)
+    {
+        using Callable = std::decay_t<F>;
+
+        static_assert(sizeof(Callable) <= Capacity, "Callable is too large for the delegate's inline storage, capture a pointer to it instead.");
+        static_assert(alignof(Callable) <= alignof(std::max_align_t), "Callable is over-aligned for the delegate's inline storage.");
+        static_assert(std::is_copy_constructible_v<Callable>, "Callable must be copy constructible.");
+
+        new (&m_storage) Callable(std::forward<F>(f));
+        m_invoke = &Operations<Callable>::Invoke;
+        m_operations = &Operations<Callable>::Table;
+    }
+
+    /**
+     * Creates a delegate that calls a member function on an object.
+     *
+     * @tparam Method The member function to call.
+     * @param instance The object to call the member function on. It must outlive the delegate.
+     * @return The delegate.
+     */
+    template <auto Method, typename C>
+    static Delegate Bind(C &instance)
+    {
+        C *pointer = &instance;
+
+        return Delegate([pointer](Args... args) -> R {
+            return (pointer->*Method)(std::forward<Args>(args)...);
+        });
+    }
+
+    Delegate(const Delegate &other)
+    {
+        copyFrom(other);
+    }
+
+    Delegate &operator=(const Delegate &other)
+    {
+        if (this != &other) {
+            reset();
+            copyFrom(other);
+        }
+
+        return *this;
+    }
+
+    Delegate &operator=(std::nullptr_t)
+    {
+        reset();
+        return *this;
+    }
+
+    R operator()(Args... args) const
+    {
+        BOOST_ASSERT_MSG(m_invoke, "Called an empty delegate!");
+        return m_invoke(&m_storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const
+    {
+        return m_invoke;
+    }
+
+    ~Delegate()
+    {
+        reset();
+    }
+
+private:
+    using Invoker = R (*)(const void *, Args &&...);
+
+    struct OperationTable {
+        void (*copy)(void *, const void *);
+        void (*destroy)(void *);
+    };
+
+    template <typename Callable>
+    struct Operations {
+        static R Invoke(const void *storage, Args &&...args)
+        {
+            // Delegates behave like std::function, calling a const delegate may call a non-const operator().
+            return (*const_cast<Callable *>(static_cast<const Callable *>(storage)))(std::forward<Args>(args)...);
+        }
+
+        static void Copy(void *destination, const void *source)
+        {
+            new (destination) Callable(*static_cast<const Callable *>(source));
+        }
+
+        static void Destroy(void *storage)
+        {
+            static_cast<Callable *>(storage)->~Callable();
+        }
+
+        static constexpr bool Trivial = std::is_trivially_copyable_v<Callable> && std::is_trivially_destructible_v<Callable>;
+
+        static constexpr OperationTable Table {
+            Trivial ? nullptr : &Copy,
+            Trivial ? nullptr : &Destroy};
+    };
+
+    void copyFrom(const Delegate &other)
+    {
+        if (!other.m_operations) {
+            return;
+        }
+
+        if (other.m_operations->copy) {
+            other.m_operations->copy(&m_storage, &other.m_storage);
+        } else {
+            m_storage = other.m_storage;
+        }
+
+        m_invoke = other.m_invoke;
+        m_operations = other.m_operations;
+    }
+
+    void reset()
+    {
+        if (m_operations && m_operations->destroy) {
+            m_operations->destroy(&m_storage);
+        }
+
+        m_invoke = nullptr;
+        m_operations = nullptr;
+    }
+
+    std::aligned_storage_t<Capacity, alignof(std::max_align_t)> m_storage;
+    // The invoker is kept inline so a call costs a single indirect jump, the table is only needed to copy and destroy.
+    Invoker m_invoke = nullptr;
+    const OperationTable *m_operations = nullptr;
+};
+
+}
+
+#endif // SILICON_DELEGATE_HPP
@@ -32,14 +32,27 @@
 #define SILICON_EVENT_HPP
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
-#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 #include "SDL_events.h"
+#include "boost/assert.hpp"
 
+#include "Async.hpp"
+#include "Delegate.hpp"
 #include "Types.hpp"
 
 namespace Si {
+
+template <typename T>
+class Sub;
+
 namespace Event {
 
     /**
@@ -50,14 +63,324 @@ namespace Event {
     struct AppQuit {};
     
     struct WindowResize {};
-    
+
+    /**
+     * Polls platform events and dispatches every queued event.
+     *
+     * Events enqueued while the queues are being dispatched are delivered on the next call.
+     */
     void Process();
 
+    /**
+     * A registry of subscribers that can be published to without locking.
+     *
+     * Subscribers live in fixed slots that never move. Publishing only performs atomic loads, so it never blocks and can run on any
+     * number of threads at once. Adding and removing subscribers is serialized by a mutex that publishers never touch. Removing a
+     * subscriber clears its slot in O(1), then waits for a grace period with the mutex released: every publish that might still be
+     * calling the removed subscriber has finished once the readers of both publish epochs have drained since the slot was cleared.
+     *
+     * Subscribers can be added and removed while publishing, including from inside a subscriber's callback on any number of threads at
+     * once. A subscriber must not be removed while its own callback is running on the removing thread, or while its callback is itself
+     * removing a subscriber on another thread, since the removal can not wait for that callback to finish.
+     *
+     * @tparam S The subscriber type.
+     */
+    template <typename S>
+    class SubscriberList
+    {
+    public:
+        using Slot = std::uint32_t;
+
+        static constexpr std::size_t ChunkSize = 256;
+        static constexpr std::size_t MaxChunks = 1024;
+
+        SubscriberList() = default;
+        SubscriberList(const SubscriberList &) = delete;
+
+        /**
+         * Adds a subscriber.
+         *
+         * @param subscriber The subscriber to add.
+         * @return The slot holding the subscriber, used to remove it.
+         */
+        Slot add(NotNull<S *> subscriber)
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+
+            Slot slot;
+
+            if (!m_freeSlots.empty()) {
+                slot = m_freeSlots.back();
+                m_freeSlots.pop_back();
+                getSlot(slot).store(subscriber, std::memory_order_release);
+                return slot;
+            }
+
+            slot = m_highWater.load(std::memory_order_relaxed);
+            std::size_t chunk = slot / ChunkSize;
+
+            BOOST_ASSERT_MSG(chunk < MaxChunks, "Too many subscribers for a single event type!");
+
+            if (!m_chunks[chunk].load(std::memory_order_relaxed)) {
+                m_chunks[chunk].store(new Chunk(), std::memory_order_release);
+                TrackAllocation(MemoryTag::Events, sizeof(Chunk));
+            }
+
+            getSlot(slot).store(subscriber, std::memory_order_release);
+            m_highWater.store(slot + 1, std::memory_order_release);
+
+            return slot;
+        }
+
+        /**
+         * Removes a subscriber. Once this returns no publish is calling the subscriber anymore.
+         *
+         * @param slot The slot returned when the subscriber was added.
+         */
+        void remove(Slot slot)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_writeMutex);
+                getSlot(slot).store(nullptr);
+            }
+
+            // Not under the mutex: a publish being waited on may add or remove subscribers from its callbacks, which takes it.
+            synchronize();
+
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            m_freeSlots.push_back(slot);
+        }
+
+        /**
+         * Calls a function with every subscriber.
+         *
+         * @param f The function to call with an S&.
+         */
+        template <typename F>
+        void forEach(F &&f)
+        {
+            std::size_t parity = m_epoch.load() & 1;
+
+            m_readers[parity].fetch_add(1);
+            t_readers[parity]++;
+
+            Slot count = m_highWater.load(std::memory_order_acquire);
+
+            for (Slot slot = 0; slot < count; slot++) {
+                if (S *subscriber = getSlot(slot).load()) {
+                    f(*subscriber);
+                }
+            }
+
+            t_readers[parity]--;
+            m_readers[parity].fetch_sub(1);
+        }
+
+        /**
+         * Delays the removal of every subscriber currently in the list until the returned pin and all of its copies are released.
+         *
+         * Unlike forEach(), a pin is not tied to a thread, so it can keep subscribers alive for callbacks running on other threads.
+         *
+         * @return The pin.
+         */
+        std::shared_ptr<void> pin()
+        {
+            std::size_t parity = m_epoch.load() & 1;
+            m_readers[parity].fetch_add(1);
+
+            return std::shared_ptr<void>(nullptr, [this, parity](void *) {
+                m_readers[parity].fetch_sub(1);
+            });
+        }
+
+        ~SubscriberList()
+        {
+            for (std::atomic<Chunk *> &chunk : m_chunks) {
+                if (Chunk *allocated = chunk.load()) {
+                    TrackDeallocation(MemoryTag::Events, sizeof(Chunk));
+                    delete allocated;
+                }
+            }
+        }
+
+    private:
+        using Chunk = std::array<std::atomic<S *>, ChunkSize>;
+
+        std::atomic<S *> &getSlot(Slot slot)
+        {
+            return (*m_chunks[slot / ChunkSize].load(std::memory_order_acquire))[slot % ChunkSize];
+        }
+
+        void synchronize()
+        {
+            // Publishes running on this thread (e.g. the one calling us) can not finish until we return, so this thread steps out of its
+            // reads while it waits. Meanwhile it is not calling any subscriber, and once it steps back in it loads every later slot again,
+            // so it can not see the one just cleared. Two threads removing subscribers from their callbacks at once therefore do not wait
+            // on each other.
+            for (std::size_t parity = 0; parity < 2; parity++) {
+                if (t_readers[parity]) {
+                    m_readers[parity].fetch_sub(t_readers[parity]);
+                }
+            }
+
+            // Several threads may be waiting at once, each flipping the epoch, so rather than counting flips, each parity is waited on
+            // until it has no readers. The epoch is moved off a parity first so new publishes can not keep it busy.
+            for (std::size_t parity = 0; parity < 2; parity++) {
+                std::uint64_t epoch = m_epoch.load();
+
+                if ((epoch & 1) == parity) {
+                    m_epoch.compare_exchange_strong(epoch, epoch + 1);
+                }
+
+                while (m_readers[parity].load()) {
+                    std::this_thread::yield();
+                }
+            }
+
+            for (std::size_t parity = 0; parity < 2; parity++) {
+                if (t_readers[parity]) {
+                    m_readers[parity].fetch_add(t_readers[parity]);
+                }
+            }
+        }
+
+        std::array<std::atomic<Chunk *>, MaxChunks> m_chunks {};
+        std::atomic<Slot> m_highWater = 0;
+
+        std::atomic<std::uint64_t> m_epoch = 0;
+        std::array<std::atomic<std::uint32_t>, 2> m_readers {};
+        inline static thread_local std::array<std::uint32_t, 2> t_readers {};
+
+        std::mutex m_writeMutex;
+        Tagged<MemoryTag::Events>::Vector<Slot> m_freeSlots;
+    };
+
+    /**
+     * Type-erased interface for the per-type event queues drained by Process().
+     */
+    class QueueBase
+    {
+    public:
+        virtual void dispatch() = 0;
+        virtual ~QueueBase() = default;
+    };
+
+    void RegisterQueue(QueueBase &queue);
+    void UnregisterQueue(QueueBase &queue);
+
+    /**
+     * Gets whether the calling thread is the one that calls Process().
+     *
+     * @return Whether the calling thread is the one that calls Process(). False until Process() has been called once.
+     */
+    [[nodiscard]] bool IsProcessThread();
+
+    /**
+     * Holds the events of type T that have been enqueued since the last Process().
+     *
+     * On the thread that calls Process(), events are appended to a contiguous buffer that is swapped out on dispatch, so after warming
+     * up publishing is a single append and every subscriber receives the whole frame's worth of events in one call. Other threads push
+     * onto a lock-free multi-producer list that is moved into the buffer when the queue is dispatched.
+     *
+     * @tparam T The type of event to hold.
+     */
+    template <typename T>
+    class Queue : public QueueBase
+    {
+    public:
+        static Queue &Get()
+        {
+            static Queue queue;
+            return queue;
+        }
+
+        template <typename U>
+        void push(U &&data)
+        {
+            if (IsProcessThread()) {
+                m_pending.emplace_back(std::forward<U>(data));
+                return;
+            }
+
+            auto *node = new ProducerNode {T(std::forward<U>(data)), m_producerHead.load(std::memory_order_relaxed)};
+            TrackAllocation(MemoryTag::Events, sizeof(ProducerNode));
+
+            while (!m_producerHead.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) { }
+        }
+
+        void dispatch() override
+        {
+            collectProducers();
+
+            if (m_pending.empty()) {
+                return;
+            }
+
+            m_pending.swap(m_dispatching);
+
+            Span<const T> events(m_dispatching.data(), m_dispatching.size());
+
+            Sub<T>::GetSubscribers().forEach([events](Sub<T> &i) {
+                i.dispatch(events);
+            });
+
+            m_dispatching.clear();
+        }
+
+        ~Queue() override
+        {
+            UnregisterQueue(*this);
+            collectProducers();
+        }
+
+    private:
+        struct ProducerNode {
+            T data;
+            ProducerNode *next;
+        };
+
+        Queue()
+        {
+            RegisterQueue(*this);
+        }
+
+        void collectProducers()
+        {
+            ProducerNode *head = m_producerHead.exchange(nullptr, std::memory_order_acquire);
+
+            // The list is newest first, reverse it to deliver events in the order they were pushed.
+            ProducerNode *reversed = nullptr;
+
+            while (head) {
+                ProducerNode *next = head->next;
+                head->next = reversed;
+                reversed = head;
+                head = next;
+            }
+
+            while (reversed) {
+                ProducerNode *next = reversed->next;
+                m_pending.emplace_back(std::move(reversed->data));
+                TrackDeallocation(MemoryTag::Events, sizeof(ProducerNode));
+                delete reversed;
+                reversed = next;
+            }
+        }
+
+        Tagged<MemoryTag::Events>::Vector<T> m_pending;
+        Tagged<MemoryTag::Events>::Vector<T> m_dispatching;
+
+        std::atomic<ProducerNode *> m_producerHead = nullptr;
+    };
+
 }
 
 template <typename T>
 void Pub(const T& data);
 
+template <typename T>
+void PubParallel(T data);
+
 /**
  * The Subscriber class allows you to listen in on published events of type T.
  * @tparam T The type of event to listen to.
@@ -66,47 +389,124 @@ template <typename T>
 class Sub
 {
     friend void Si::Pub<T>(const T& data);
-    using Callback = std::function<void(const T&)>;
+    friend void Si::PubParallel<T>(T data);
+    friend class Event::Queue<T>;
 
 public:
+    /**
+     * The callback types are allocation-free delegates. Member functions can be subscribed with Callback::Bind<&Class::method>(object).
+     */
+    using Callback = Delegate<void(const T&)>;
+    using BatchCallback = Delegate<void(Span<const T>)>;
+
     /**
      * Creates a new subscriber with the function to call on an event publish.
      * @param func The function to run when the event is called.
      */
     explicit Sub(Callback func)
-        : Func(func)
+        : Func(std::move(func))
+        , SubscriberSlot(GetSubscribers().add(NotNull<Sub<T>*>(this)))
     {
-        Sub<T>::Subscribers.push_back(NotNull<Sub<T>*>(this));
     }
 
-    ~Sub()
+    /**
+     * Creates a new subscriber that receives queued events in batches.
+     * @param func The function to run with every event of type T enqueued since the last Event::Process().
+     */
+    template <typename F, typename = std::enable_if_t<std::is_invocable_v<F, Span<const T>> && !std::is_invocable_v<F, const T&>>>
+    explicit Sub(F func)
+        : BatchFunc(std::move(func))
+        , SubscriberSlot(GetSubscribers().add(NotNull<Sub<T>*>(this)))
     {
-        const auto& i = std::find(Sub<T>::Subscribers.begin(), Sub<T>::Subscribers.end(), this);
+    }
+
+    Sub(const Sub&) = delete;
+    Sub& operator=(const Sub&) = delete;
 
-        if (i != Sub<T>::Subscribers.end())
-            Sub<T>::Subscribers.erase(i);
+    /**
+     * Unsubscribes. Once destroyed, the callback is no longer running on any thread.
+     */
+    ~Sub()
+    {
+        GetSubscribers().remove(SubscriberSlot);
     }
 
 private:
-    static std::vector<NotNull<Sub<T>*>> Subscribers;
+    void dispatch(Span<const T> events)
+    {
+        if (BatchFunc) {
+            BatchFunc(events);
+            return;
+        }
+
+        for (const T& event : events) {
+            Func(event);
+        }
+    }
+
+    static Event::SubscriberList<Sub<T>>& GetSubscribers()
+    {
+        static Event::SubscriberList<Sub<T>> subscribers;
+        return subscribers;
+    }
+
     Callback Func;
+    BatchCallback BatchFunc;
+    typename Event::SubscriberList<Sub<T>>::Slot SubscriberSlot;
 };
 
 /**
- * Publishes an event of type T to all subscribers immediately.
+ * Publishes an event of type T to all subscribers immediately, on the calling thread.
+ *
+ * Safe to call from any thread, including while subscribers are being created or destroyed on others.
+ *
  * @tparam  T       The type of event to publish.
  * @param   data    An instance of the event to broadcast to all subscribers.
  */
 template <class T>
 void Pub(const T& data)
 {
-    for (Sub<T>* i : Sub<T>::Subscribers) {
-        i->Func(data);
-    }
+    Sub<T>::GetSubscribers().forEach([&data](Sub<T>& i) {
+        i.dispatch(Span<const T>(&data, 1));
+    });
 }
 
+/**
+ * Publishes an event of type T to all subscribers in parallel on the async executor, without waiting for them.
+ *
+ * Every subscriber is called on its own task, so a slow subscriber does not hold up the others or the publisher. Destroying a subscriber
+ * waits for any of these calls that are still pending, so callbacks must not destroy subscribers to the same type of event.
+ *
+ * @tparam  T       The type of event to publish.
+ * @param   data    An instance of the event to broadcast to all subscribers.
+ */
 template <typename T>
-std::vector<NotNull<Sub<T>*>> Sub<T>::Subscribers;
+void PubParallel(T data)
+{
+    auto event = std::make_shared<const T>(std::move(data));
+    auto &subscribers = Sub<T>::GetSubscribers();
+    std::shared_ptr<void> pin = subscribers.pin();
+
+    subscribers.forEach([&event, &pin](Sub<T>& i) {
+        Async([event, pin, &i]() {
+            i.dispatch(Span<const T>(event.get(), 1));
+        });
+    });
+}
+
+/**
+ * Queues an event of type T to be published to all subscribers on the next Event::Process().
+ *
+ * Safe to call from any thread. Events are always delivered on the thread that calls Event::Process().
+ *
+ * @tparam  T       The type of event to queue.
+ * @param   data    An instance of the event to broadcast to all subscribers.
+ */
+template <class T>
+void Enqueue(T&& data)
+{
+    Event::Queue<std::decay_t<T>>::Get().push(std::forward<T>(data));
+}
 
 }
 
@@ -0,0 +1,299 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/22/23.
+//
+
+#ifndef SILICON_MEMORYRESOURCE_HPP
+#define SILICON_MEMORYRESOURCE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "Allocator.hpp"
+
+namespace Si {
+
+/**
+ * An interface for a source of memory that containers can be handed at runtime, in the style of
+ * std::pmr::memory_resource.
+ */
+class MemoryResource {
+public:
+    virtual ~MemoryResource() = default;
+
+    /**
+     * Allocates memory from the resource.
+     *
+     * @param bytes The number of bytes to allocate.
+     * @param alignment The alignment of the allocation. Must be a power of two.
+     * @return A pointer to the allocated memory.
+     */
+    void *Allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+    {
+        return allocateImpl(bytes, alignment);
+    }
+
+    /**
+     * Returns memory to the resource.
+     *
+     * @param pointer A pointer returned by Allocate() on an equal resource.
+     * @param bytes The size passed to Allocate().
+     * @param alignment The alignment passed to Allocate().
+     */
+    void Deallocate(void *pointer, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+    {
+        deallocateImpl(pointer, bytes, alignment);
+    }
+
+    /**
+     * @param other The resource to compare against.
+     * @return Whether memory allocated from one resource can be freed by the other.
+     */
+    bool IsEqual(const MemoryResource &other) const noexcept
+    {
+        return (this == &other) || isEqualImpl(other);
+    }
+
+protected:
+    virtual void *allocateImpl(std::size_t bytes, std::size_t alignment) = 0;
+    virtual void deallocateImpl(void *pointer, std::size_t bytes, std::size_t alignment) = 0;
+    virtual bool isEqualImpl(const MemoryResource &other) const noexcept { return false; }
+};
+
+/**
+ * @return A resource that allocates with the global operator new.
+ */
+MemoryResource *GetNewDeleteResource();
+
+/**
+ * @return A resource that allocates from the calling thread's frame arena. Memory is valid until the end of the current
+ * frame.
+ */
+MemoryResource *GetFrameResource();
+
+/**
+ * @return The resource used by default constructed polymorphic allocators.
+ */
+MemoryResource *GetDefaultResource();
+
+/**
+ * Sets the resource used by default constructed polymorphic allocators.
+ *
+ * @param resource The new default resource, or nullptr to restore the new/delete resource.
+ * @return The previous default resource.
+ */
+MemoryResource *SetDefaultResource(MemoryResource *resource);
+
+/**
+ * Hands out memory from a buffer by bumping a pointer, falling back to increasingly large blocks from an upstream
+ * resource. Deallocation does nothing; everything is freed at once by Release() or on destruction. Not thread-safe.
+ */
+class MonotonicBufferResource : public MemoryResource {
+public:
+    explicit MonotonicBufferResource(MemoryResource *upstream = GetDefaultResource());
+    MonotonicBufferResource(void *buffer, std::size_t size, MemoryResource *upstream = GetDefaultResource());
+    MonotonicBufferResource(const MonotonicBufferResource &) = delete;
+    MonotonicBufferResource &operator=(const MonotonicBufferResource &) = delete;
+    ~MonotonicBufferResource() override;
+
+    /**
+     * Frees every block taken from the upstream resource and starts over from the initial buffer.
+     */
+    void Release();
+
+    MemoryResource *GetUpstream() const { return m_upstream; }
+
+protected:
+    void *allocateImpl(std::size_t bytes, std::size_t alignment) override;
+    void deallocateImpl(void *pointer, std::size_t bytes, std::size_t alignment) override { }
+
+private:
+    struct Block;
+
+    MemoryResource *m_upstream;
+    void *m_initialBuffer;
+    std::size_t m_initialSize;
+    std::uint8_t *m_current;
+    std::size_t m_remaining;
+    std::size_t m_nextBlockSize;
+    Block *m_blocks = nullptr;
+};
+
+/**
+ * A MonotonicBufferResource with its initial buffer stored inline, so a resource on the stack serves small workloads
+ * without touching the heap.
+ */
+template <std::size_t Size>
+class InlineBufferResource : public MonotonicBufferResource {
+public:
+    explicit InlineBufferResource(MemoryResource *upstream = GetDefaultResource())
+        : MonotonicBufferResource(m_buffer, Size, upstream)
+    {
+    }
+
+private:
+    alignas(std::max_align_t) std::uint8_t m_buffer[Size];
+};
+
+/**
+ * Pools of fixed size blocks carved from chunks of an upstream resource. Freed blocks are reused by later allocations
+ * of the same size class. Large allocations go straight to the upstream resource. Not thread-safe.
+ */
+class UnsynchronizedPoolResource : public MemoryResource {
+public:
+    static constexpr std::size_t MaxPooledSize = 4096;
+
+    explicit UnsynchronizedPoolResource(MemoryResource *upstream = GetDefaultResource());
+    UnsynchronizedPoolResource(const UnsynchronizedPoolResource &) = delete;
+    UnsynchronizedPoolResource &operator=(const UnsynchronizedPoolResource &) = delete;
+    ~UnsynchronizedPoolResource() override;
+
+    /**
+     * Returns every chunk to the upstream resource. Pooled blocks must no longer be in use.
+     */
+    void Release();
+
+    MemoryResource *GetUpstream() const { return m_upstream; }
+
+protected:
+    void *allocateImpl(std::size_t bytes, std::size_t alignment) override;
+    void deallocateImpl(void *pointer, std::size_t bytes, std::size_t alignment) override;
+
+private:
+    static constexpr std::size_t MinPooledSize = 8;
+    static constexpr std::size_t PoolCount = 10;
+
+    struct FreeBlock;
+    struct Chunk;
+
+    static std::size_t GetPoolIndex(std::size_t bytes, std::size_t alignment);
+
+    MemoryResource *m_upstream;
+    FreeBlock *m_freeLists[PoolCount] {};
+    std::size_t m_chunkBlockCounts[PoolCount] {};
+    Chunk *m_chunks = nullptr;
+};
+
+/**
+ * Forwards to an upstream resource while counting the memory that passes through it. Counting is thread-safe; the
+ * upstream resource decides whether allocation is.
+ */
+class TrackingResource : public MemoryResource {
+public:
+    struct Stats {
+        std::size_t liveBytes;
+        std::size_t peakBytes;
+        std::size_t liveAllocations;
+        std::size_t totalAllocations;
+    };
+
+    explicit TrackingResource(MemoryResource *upstream = GetDefaultResource());
+
+    /**
+     * @return The memory currently allocated through this resource, and the most that has been at once.
+     */
+    Stats GetStats() const;
+
+    MemoryResource *GetUpstream() const { return m_upstream; }
+
+protected:
+    void *allocateImpl(std::size_t bytes, std::size_t alignment) override;
+    void deallocateImpl(void *pointer, std::size_t bytes, std::size_t alignment) override;
+
+private:
+    MemoryResource *m_upstream;
+    std::atomic<std::size_t> m_liveBytes {0};
+    std::atomic<std::size_t> m_peakBytes {0};
+    std::atomic<std::size_t> m_liveAllocations {0};
+    std::atomic<std::size_t> m_totalAllocations {0};
+};
+
+/**
+ * STL allocator that allocates from a MemoryResource chosen at runtime, in the style of
+ * std::pmr::polymorphic_allocator. Copies of a container fall back to the default resource, and elements that are
+ * themselves containers do not inherit the resource.
+ */
+template <typename T>
+class PolymorphicAllocator {
+public:
+    using value_type = T;
+
+    PolymorphicAllocator() noexcept
+        : m_resource(GetDefaultResource())
+    {
+    }
+
+    PolymorphicAllocator(MemoryResource *resource) noexcept
+        : m_resource(resource)
+    {
+    }
+
+    template <typename U>
+    PolymorphicAllocator(const PolymorphicAllocator<U> &other) noexcept
+        : m_resource(other.getResource())
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        return static_cast<T *>(m_resource->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *pointer, std::size_t n) noexcept
+    {
+        m_resource->Deallocate(pointer, n * sizeof(T), alignof(T));
+    }
+
+    PolymorphicAllocator select_on_container_copy_construction() const
+    {
+        return {};
+    }
+
+    MemoryResource *getResource() const noexcept { return m_resource; }
+
+private:
+    MemoryResource *m_resource;
+};
+
+template <typename T, typename U>
+bool operator==(const PolymorphicAllocator<T> &lhs, const PolymorphicAllocator<U> &rhs) noexcept
+{
+    return lhs.getResource()->IsEqual(*rhs.getResource());
+}
+
+template <typename T, typename U>
+bool operator!=(const PolymorphicAllocator<T> &lhs, const PolymorphicAllocator<U> &rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+}
+
+#endif // SILICON_MEMORYRESOURCE_HPP
@@ -0,0 +1,122 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/23/23.
+//
+
+#ifndef SILICON_MEMORYTRACKING_HPP
+#define SILICON_MEMORYTRACKING_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace Si {
+
+/**
+ * The subsystem an allocation is accounted to.
+ */
+enum class MemoryTag : std::uint8_t {
+    General,
+    Nodes,
+    Events,
+    Assets,
+    Renderer,
+    Logging,
+    GPU,
+    Count
+};
+
+/**
+ * The memory accounted to a single tag.
+ */
+struct MemoryTagStats {
+    std::int64_t liveBytes;
+    std::int64_t peakBytes;
+    std::int64_t liveAllocations;
+    std::uint64_t totalAllocations;
+};
+
+/**
+ * The memory accounted to every tag at a point in time.
+ */
+struct MemorySnapshot {
+    std::array<MemoryTagStats, static_cast<std::size_t>(MemoryTag::Count)> tags;
+
+    const MemoryTagStats &operator[](MemoryTag tag) const
+    {
+        return tags[static_cast<std::size_t>(tag)];
+    }
+
+    /**
+     * @return The sum of every tag. The peak is the sum of each tag's peak, so it may never have been reached at once.
+     */
+    [[nodiscard]] MemoryTagStats getTotal() const;
+};
+
+/**
+ * Gets a human readable name for a tag.
+ *
+ * @param tag The tag.
+ * @return The name of the tag.
+ */
+const char *GetMemoryTagName(MemoryTag tag);
+
+/**
+ * Accounts an allocation to a tag. Counters are kept per thread and folded into the totals every 64 KiB, so this never
+ * takes a lock.
+ *
+ * @param tag The tag to account the allocation to.
+ * @param bytes The size of the allocation.
+ */
+void TrackAllocation(MemoryTag tag, std::size_t bytes);
+
+/**
+ * Accounts a deallocation to a tag. The deallocation may happen on a different thread than the allocation.
+ *
+ * @param tag The tag the allocation was accounted to.
+ * @param bytes The size of the allocation.
+ */
+void TrackDeallocation(MemoryTag tag, std::size_t bytes);
+
+/**
+ * Takes a snapshot of the memory accounted to every tag. Live counts are exact once other threads stop allocating;
+ * peaks are accurate to within 64 KiB per thread.
+ *
+ * @return The snapshot.
+ */
+MemorySnapshot GetMemorySnapshot();
+
+/**
+ * Logs a snapshot of the memory accounted to every tag.
+ */
+void LogMemorySnapshot();
+
+}
+
+#endif // SILICON_MEMORYTRACKING_HPP
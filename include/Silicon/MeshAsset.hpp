@@ -0,0 +1,144 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/19/23.
+//
+
+#ifndef SILICON_MESHASSET_HPP
+#define SILICON_MESHASSET_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "Silicon/Asset.hpp"
+#include "Silicon/Renderer/Vertex.hpp"
+#include "Silicon/Types.hpp"
+
+namespace Si {
+
+/**
+ * A mesh's vertices and indices, packed into a single staging buffer ready to upload.
+ *
+ * The staging buffer holds every vertex followed by every index. Each primitive's indices are relative to its own first vertex.
+ *
+ * Loads glTF and GLB, decoding accessors in parallel on the async executor straight into their place in the staging buffer. Also loads
+ * meshes cooked with Cook(), whose staging buffer is viewed straight from the file with no decoding at all.
+ */
+class MeshAsset : public Asset
+{
+public:
+    using Index = std::uint32_t;
+
+    struct Primitive {
+        /// The offset of the primitive's first vertex, in vertices.
+        std::uint32_t vertexOffset;
+        std::uint32_t vertexCount;
+        /// The offset of the primitive's first index, in indices.
+        std::uint32_t firstIndex;
+        std::uint32_t indexCount;
+    };
+
+    struct Mesh {
+        std::string name;
+        Vector<Primitive> primitives;
+    };
+
+    static constexpr std::uint32_t CookedMagic = 0x534d4953; // "SIMS"
+    static constexpr std::uint32_t CookedVersion = 1;
+    static constexpr std::uint64_t CookedAlignment = 64;
+
+    /**
+     * The cooked layout, all little-endian: the header, the meshes, the primitives, the mesh names, then the staging buffer aligned to
+     * CookedAlignment.
+     */
+    struct CookedHeader {
+        std::uint32_t magic;
+        std::uint32_t version;
+        /// sizeof(Vertex) when cooked, a mismatch means the mesh must be cooked again.
+        std::uint32_t vertexSize;
+        std::uint32_t meshCount;
+        std::uint32_t primitiveCount;
+        std::uint32_t reserved;
+        std::uint64_t vertexCount;
+        std::uint64_t indexCount;
+        std::uint64_t meshesOffset;
+        std::uint64_t primitivesOffset;
+        std::uint64_t namesOffset;
+        std::uint64_t stagingOffset;
+        std::uint64_t stagingSize;
+    };
+
+    struct CookedMesh {
+        std::uint32_t nameOffset;
+        std::uint32_t nameLength;
+        std::uint32_t firstPrimitive;
+        std::uint32_t primitiveCount;
+    };
+
+    explicit MeshAsset(std::string path);
+
+    [[nodiscard]] Span<const Mesh> GetMeshes() const;
+
+    [[nodiscard]] Span<const Vertex> GetVertices() const;
+    [[nodiscard]] Span<const Index> GetIndices() const;
+
+    /**
+     * @return The vertices followed by the indices, starting at GetIndexOffset().
+     */
+    [[nodiscard]] Span<const std::uint8_t> GetStagingBuffer() const;
+
+    /**
+     * @return The offset of the indices within the staging buffer, in bytes.
+     */
+    [[nodiscard]] std::size_t GetIndexOffset() const;
+
+    [[nodiscard]] std::size_t GetResidentSize() const override;
+
+    /**
+     * Writes the mesh in the cooked layout, which loads without any parsing or decoding.
+     *
+     * @param path Where to write the cooked mesh.
+     * @return Whether the mesh was written.
+     */
+    bool Cook(const std::string &path) const;
+
+private:
+    void loadGltf();
+    void loadCooked();
+
+    Vector<Mesh> m_meshes;
+    // Only used by meshes decoded from glTF, cooked meshes view the staging buffer in the asset's bytes.
+    Tagged<MemoryTag::Assets>::Vector<std::uint8_t> m_decoded;
+    Span<const std::uint8_t> m_staging;
+    std::size_t m_vertexCount = 0;
+    std::size_t m_indexCount = 0;
+};
+
+}
+
+#endif // SILICON_MESHASSET_HPP
@@ -32,17 +32,15 @@
 #define SILICON_NODE_HPP
 
 #include <initializer_list>
+#include <utility>
 
+#include "NodeHierarchy.hpp"
 #include "Types.hpp"
 
 namespace Si {
 
-class Node;
-
-using NodeGraph = Graph<NotNull<Node *>, GraphList>;
-
 /*
- * A Node is a base class for all objects that can be added to a NodeGraph.
+ * A Node is a base class for all objects that can be added to a NodeHierarchy.
  */
 class Node
 {
@@ -51,7 +49,7 @@ public:
     class ChildIterator
     {
     public:
-        explicit ChildIterator(NodeGraph::adjacency_iterator);
+        ChildIterator(NodeHandle parent, NodeHandle child);
 
         Node& operator*();
         Node* operator->();
@@ -65,7 +63,8 @@ public:
         bool operator!=(const ChildIterator &other);
 
     private:
-        NodeGraph::adjacency_iterator m_itr;
+        NodeHandle m_parent;
+        NodeHandle m_child;
     };
 
     /**
@@ -81,14 +80,14 @@ public:
     Node(std::initializer_list<Node *> children);
 
     /**
-     * Add a child to this node
+     * Add a child to this node. If the child already has a parent, it is moved to this node.
      *
      * @param node The child to add
      */
     void addChild(NotNull<Node *>);
 
     /**
-     * Add a child to this node
+     * Add a child to this node. If the child already has a parent, it is moved to this node.
      *
      * @param node The child to add
      */
@@ -101,6 +100,18 @@ public:
      */
     Node &addChildren(std::initializer_list<Node *> children);
 
+    /**
+     * Gets the parent of this node
+     * @return The parent, or nullptr if this node is a root
+     */
+    [[nodiscard]] Node *getParent() const;
+
+    /**
+     * Gets the handle of this node in the node hierarchy
+     * @return The handle of this node
+     */
+    [[nodiscard]] NodeHandle getHandle() const;
+
     /**
      * Gets the begin iterator for the children of this node
      * @return The begin iterator
@@ -114,16 +125,44 @@ public:
     [[nodiscard]] ChildIterator end() const;
 
     /**
-     * Destroys this node.
+     * Visits this node and all of its descendants in depth-first order as a linear scan.
+     *
+     * The visitor must not add, remove or re-parent nodes.
+     *
+     * @param f The visitor, called with a Node&
+     */
+    template <typename F>
+    void traverse(F &&f) const
+    {
+        s_hierarchy.forEachInSubtree(m_handle, std::forward<F>(f));
+    }
+
+    /**
+     * Visits this node and all of its descendants across the async executor.
+     *
+     * Every node is visited after its parent, sibling subtrees are visited concurrently. The visitor must be thread-safe and must not
+     * add, remove or re-parent nodes. Blocks until every node is visited.
+     *
+     * @param f The visitor, called with a Node&
+     * @param grainSize The number of nodes to aim to visit per task
+     */
+    template <typename F>
+    void parallelTraverse(F &&f, NodeHierarchy::Index grainSize = NodeHierarchy::DefaultGrainSize) const
+    {
+        s_hierarchy.parallelForEachInSubtree(m_handle, std::forward<F>(f), grainSize);
+    }
+
+    /**
+     * Destroys this node. Its children become roots.
      */
     virtual ~Node();
 
 protected:
     unsigned m_id = 0;
-    NodeGraph::vertex_descriptor m_graphDescriptor;
+    NodeHandle m_handle;
 
     static unsigned s_currentID;
-    static NodeGraph s_graph;
+    static NodeHierarchy s_hierarchy;
 };
 
 }
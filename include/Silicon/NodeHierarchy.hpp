@@ -0,0 +1,325 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/9/23.
+//
+
+#ifndef SILICON_NODEHIERARCHY_HPP
+#define SILICON_NODEHIERARCHY_HPP
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "Async.hpp"
+#include "Types.hpp"
+
+namespace Si {
+
+class Node;
+
+/**
+ * A generation checked reference to a node stored in a NodeHierarchy.
+ *
+ * Handles stay valid while their node is moved around inside the hierarchy, and are detected as stale once the node is erased and its slot is reused.
+ */
+struct NodeHandle {
+    std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t generation = 0;
+
+    bool operator==(const NodeHandle &other) const
+    {
+        return (index == other.index) && (generation == other.generation);
+    }
+
+    bool operator!=(const NodeHandle &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * A flat, index based store for a forest of nodes.
+ *
+ * The parent, first child, last child, next sibling and previous sibling links are kept in contiguous arrays. Inserting, erasing and
+ * re-parenting nodes is O(1) (erasing also orphans the node's children), after which the arrays are lazily reordered into depth-first
+ * order on the next traversal. Once sorted, every subtree occupies a contiguous range so full and partial traversals are linear scans.
+ *
+ * The hierarchy is not thread-safe.
+ */
+class NodeHierarchy
+{
+public:
+    using Index = std::uint32_t;
+
+    static constexpr Index NullIndex = std::numeric_limits<Index>::max();
+
+    /**
+     * The number of nodes a parallel traversal aims to visit per task.
+     */
+    static constexpr Index DefaultGrainSize = 1024;
+
+    /**
+     * Inserts a node as a new root.
+     *
+     * @param node The node to insert.
+     * @return The handle to the inserted node.
+     */
+    NodeHandle insert(NotNull<Node *> node);
+
+    /**
+     * Erases a node. Its children become roots and all existing handles to it become invalid.
+     *
+     * @param handle The node to erase.
+     */
+    void erase(NodeHandle handle);
+
+    /**
+     * Makes a node the last child of another, detaching it from its previous parent.
+     *
+     * @param parent The new parent.
+     * @param child The node to attach.
+     */
+    void attach(NodeHandle parent, NodeHandle child);
+
+    /**
+     * Detaches a node from its parent, making it a root.
+     *
+     * @param child The node to detach.
+     */
+    void detach(NodeHandle child);
+
+    /**
+     * Gets whether a handle refers to a node that is still in the hierarchy.
+     *
+     * @param handle The handle to check.
+     * @return Whether the handle is valid.
+     */
+    [[nodiscard]] bool isValid(NodeHandle handle) const;
+
+    [[nodiscard]] Node *getNode(NodeHandle handle) const;
+    [[nodiscard]] NodeHandle getParent(NodeHandle handle) const;
+    [[nodiscard]] NodeHandle getFirstChild(NodeHandle handle) const;
+    [[nodiscard]] NodeHandle getLastChild(NodeHandle handle) const;
+    [[nodiscard]] NodeHandle getNextSibling(NodeHandle handle) const;
+    [[nodiscard]] NodeHandle getPrevSibling(NodeHandle handle) const;
+
+    /**
+     * Gets the number of nodes in the hierarchy.
+     *
+     * @return The number of nodes in the hierarchy.
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * Reorders the storage into depth-first order if the structure changed since the last sort.
+     */
+    void sort();
+
+    /**
+     * Gets the depth-first position of a node. Only meaningful until the structure of the hierarchy changes.
+     *
+     * @param handle The node to get the position of.
+     * @return The position of the node after sorting.
+     */
+    [[nodiscard]] Index getPosition(NodeHandle handle);
+
+    /**
+     * Gets the number of nodes (including itself) in the subtree rooted at a depth-first position.
+     *
+     * @param position The depth-first position of the subtree root.
+     * @return The size of the subtree.
+     */
+    [[nodiscard]] Index getSubtreeSize(Index position);
+
+    [[nodiscard]] Index getParentPosition(Index position);
+    [[nodiscard]] Node &getNodeAt(Index position);
+
+    /**
+     * Visits every node in the hierarchy in depth-first order.
+     *
+     * The visitor must not change the structure of the hierarchy.
+     *
+     * @param f The visitor, called with a Node&.
+     */
+    template <typename F>
+    void forEach(F &&f)
+    {
+        sort();
+
+        for (Node *node : m_nodes) {
+            f(*node);
+        }
+    }
+
+    /**
+     * Visits a node and all of its descendants in depth-first order.
+     *
+     * The visitor must not change the structure of the hierarchy.
+     *
+     * @param root The root of the subtree to visit.
+     * @param f The visitor, called with a Node&.
+     */
+    template <typename F>
+    void forEachInSubtree(NodeHandle root, F &&f)
+    {
+        Index begin = getPosition(root);
+        Index end = begin + m_subtreeSizes[begin];
+
+        for (Index i = begin; i < end; i++) {
+            f(*m_nodes[i]);
+        }
+    }
+
+    /**
+     * Visits every node in the hierarchy across the async executor.
+     *
+     * Every node is visited after its parent. Sibling subtrees are visited concurrently, so the visitor must be safe to call from
+     * multiple threads at once and must not change the structure of the hierarchy. Blocks until every node is visited, and must not be
+     * called from inside an async task.
+     *
+     * @param f The visitor, called with a Node&.
+     * @param grainSize The number of nodes to aim to visit per task.
+     */
+    template <typename F>
+    void parallelForEach(F &&f, Index grainSize = DefaultGrainSize)
+    {
+        sort();
+
+        tf::Taskflow taskflow;
+        taskflow.emplace([this, &f, grainSize](tf::Subflow &subflow) {
+            visitSubtrees(0, static_cast<Index>(m_nodes.size()), grainSize, f, subflow);
+        });
+
+        GetAsyncExecutor().run(taskflow).wait();
+    }
+
+    /**
+     * Visits a node and all of its descendants across the async executor.
+     *
+     * Every node is visited after its parent. Sibling subtrees are visited concurrently, so the visitor must be safe to call from
+     * multiple threads at once and must not change the structure of the hierarchy. Blocks until every node is visited, and must not be
+     * called from inside an async task.
+     *
+     * @param root The root of the subtree to visit.
+     * @param f The visitor, called with a Node&.
+     * @param grainSize The number of nodes to aim to visit per task.
+     */
+    template <typename F>
+    void parallelForEachInSubtree(NodeHandle root, F &&f, Index grainSize = DefaultGrainSize)
+    {
+        Index begin = getPosition(root);
+
+        if (m_subtreeSizes[begin] <= grainSize) {
+            forEachInSubtree(root, f);
+            return;
+        }
+
+        tf::Taskflow taskflow;
+        taskflow.emplace([this, &f, begin, grainSize](tf::Subflow &subflow) {
+            f(*m_nodes[begin]);
+            visitSubtrees(begin + 1, begin + m_subtreeSizes[begin], grainSize, f, subflow);
+        });
+
+        GetAsyncExecutor().run(taskflow).wait();
+    }
+
+private:
+    struct Slot {
+        Index position = NullIndex;
+        std::uint32_t generation = 0;
+    };
+
+    [[nodiscard]] Index getCheckedPosition(NodeHandle handle) const;
+    [[nodiscard]] NodeHandle getHandleAt(Index position) const;
+    [[nodiscard]] bool isAncestor(Index ancestor, Index position) const;
+
+    void unlink(Index position);
+    void move(Index from, Index to);
+
+    /*
+     * Spawns tasks for a run of sibling subtrees occupying [begin, end). Large subtrees get a task of their own that visits the
+     * subtree root and then recurses into its children, consecutive small subtrees are batched into linear scans of about grainSize.
+     */
+    template <typename F>
+    void visitSubtrees(Index begin, Index end, Index grainSize, F &f, tf::Subflow &subflow)
+    {
+        auto scan = [this, &f](Index scanBegin, Index scanEnd) {
+            for (Index i = scanBegin; i < scanEnd; i++) {
+                f(*m_nodes[i]);
+            }
+        };
+
+        Index batchBegin = begin;
+
+        for (Index subtree = begin; subtree < end; subtree += m_subtreeSizes[subtree]) {
+            Index subtreeEnd = subtree + m_subtreeSizes[subtree];
+
+            if (m_subtreeSizes[subtree] > grainSize) {
+                if (batchBegin < subtree) {
+                    subflow.emplace([scan, batchBegin, subtree]() { scan(batchBegin, subtree); });
+                }
+
+                subflow.emplace([this, &f, subtree, subtreeEnd, grainSize](tf::Subflow &childSubflow) {
+                    f(*m_nodes[subtree]);
+                    visitSubtrees(subtree + 1, subtreeEnd, grainSize, f, childSubflow);
+                });
+
+                batchBegin = subtreeEnd;
+            } else if (subtreeEnd - batchBegin >= grainSize) {
+                subflow.emplace([scan, batchBegin, subtreeEnd]() { scan(batchBegin, subtreeEnd); });
+                batchBegin = subtreeEnd;
+            }
+        }
+
+        if (batchBegin < end) {
+            subflow.emplace([scan, batchBegin, end]() { scan(batchBegin, end); });
+        }
+    }
+
+    template <typename T>
+    using NodeVector = Tagged<MemoryTag::Nodes>::Vector<T>;
+
+    NodeVector<Node *> m_nodes;
+    NodeVector<Index> m_parents;
+    NodeVector<Index> m_firstChildren;
+    NodeVector<Index> m_lastChildren;
+    NodeVector<Index> m_nextSiblings;
+    NodeVector<Index> m_prevSiblings;
+    NodeVector<Index> m_subtreeSizes;
+    NodeVector<Index> m_slotIndices;
+
+    NodeVector<Slot> m_slots;
+    NodeVector<Index> m_freeSlots;
+
+    bool m_sorted = true;
+};
+
+}
+
+#endif // SILICON_NODEHIERARCHY_HPP
@@ -31,8 +31,11 @@
 #ifndef SILICON_RENDERER_HPP
 #define SILICON_RENDERER_HPP
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <functional>
+#include <string>
 
 #include "Silicon/Types.hpp"
 #include "Vertex.hpp"
@@ -46,6 +49,28 @@ class Renderer
 {
 public:
 
+    /**
+     * A draw of the renderer's geometry. It is indexed when indexCount is not zero, and draws instanceCount instances either way.
+     */
+    struct DrawCommand {
+        std::uint32_t vertexCount = 0; ///< How many vertices a non-indexed draw reads.
+        std::uint32_t firstVertex = 0; ///< The first vertex, or for an indexed draw the value added to every index.
+        std::uint32_t indexCount = 0;
+        std::uint32_t firstIndex = 0;
+        std::uint32_t instanceCount = 1;
+        std::uint32_t firstInstance = 0;
+    };
+
+    /**
+     * How often and for how long the CPU had to wait for the GPU to finish an earlier frame before it could record the next one.
+     */
+    struct FrameStats {
+        std::uint64_t frames = 0;
+        std::uint64_t stalledFrames = 0;
+        std::chrono::nanoseconds totalStall {};
+        std::chrono::nanoseconds maxStall {};
+    };
+
     /**
      * @brief Registers a renderer implementation with the renderer. This will be called by the modules that provide a renderer implementation.
      *
@@ -53,8 +78,81 @@ public:
      */
     static void RegisterRenderer(const std::string &name, std::unique_ptr<Renderer> renderer);
 
+    /**
+     * @brief Gets a renderer registered with RegisterRenderer.
+     *
+     * @param name The name the renderer was registered under.
+     * @return The renderer, or nullptr if there is none by that name.
+     */
+    static Renderer *GetRenderer(const std::string &name);
+
     virtual bool Draw() = 0;
 
+    /**
+     * @brief Sets the vertices draws read from. They are uploaded again with every frame, so they can change as often as needed.
+     *
+     * @param vertices The vertices.
+     */
+    void SetVertices(Span<const Vertex> vertices)
+    {
+        m_vertices.assign(vertices.begin(), vertices.end());
+    }
+
+    /**
+     * @brief Sets the indices indexed draws read from.
+     *
+     * @param indices The indices into the vertices.
+     */
+    void SetIndices(Span<const std::uint32_t> indices)
+    {
+        m_indices.assign(indices.begin(), indices.end());
+    }
+
+    /**
+     * @brief Sets the per-instance attributes instanced draws read from. With none set, every draw is a single untransformed instance.
+     *
+     * @param instances The instances.
+     */
+    void SetInstances(Span<const InstanceData> instances)
+    {
+        m_instances.assign(instances.begin(), instances.end());
+    }
+
+    /**
+     * @brief Queues a draw for the next frame. The queue is emptied by Draw().
+     *
+     * If nothing was queued, Draw() draws all of m_indices, or all of m_vertices if there are no indices, once for every instance.
+     *
+     * @param draw The draw.
+     */
+    void Submit(const DrawCommand &draw)
+    {
+        m_drawCommands.push_back(draw);
+    }
+
+    /**
+     * @brief Gets the pixels of the last frame drawn, for renderers that draw offscreen.
+     *
+     * Waits for the GPU to finish that frame if it has not already. The pixels are tightly packed RGBA8 rows, top row first, and stay
+     * valid until the same frame slot is drawn to again.
+     *
+     * @return The pixels of the last frame, or an empty span if the renderer presents to a window instead.
+     */
+    virtual Span<const std::uint8_t> GetPixels()
+    {
+        return {};
+    }
+
+    /**
+     * @brief Gets how much time the CPU has spent waiting on frames still in flight.
+     *
+     * @return The stall statistics since the renderer was created.
+     */
+    [[nodiscard]] const FrameStats &GetFrameStats() const
+    {
+        return m_frameStats;
+    }
+
     virtual ~Renderer() = default;
 
 protected:
@@ -62,6 +160,10 @@ protected:
     virtual void OnResize() = 0;
 
     Si::Vector<Si::Vertex> m_vertices;
+    Si::Vector<std::uint32_t> m_indices;
+    Si::Vector<Si::InstanceData> m_instances;
+    Si::Vector<DrawCommand> m_drawCommands;
+    FrameStats m_frameStats;
 
 
 };
@@ -51,6 +51,21 @@ struct Vertex {
     std::array<T, 2> static getAttributeDescriptions();
 };
 
+/**
+ * Attributes read once per instance instead of once per vertex, so one draw can place many copies of the same mesh. The offset is
+ * added to each vertex position and the tint multiplies each vertex color.
+ */
+struct InstanceData {
+    Vec2 offset;
+    Vec3 tint;
+
+    template <typename T>
+    T static getBindingDescription();
+
+    template <typename T>
+    std::array<T, 2> static getAttributeDescriptions();
+};
+
 }
 
 #endif // SILICON_VERTEX_HPP
@@ -0,0 +1,75 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+//
+// Created by Matthew McCall on 1/24/23.
+//
+
+#ifndef SILICON_VULKANRENDERER_HPP
+#define SILICON_VULKANRENDERER_HPP
+
+#include <cstdint>
+
+#include "Silicon/Window.hpp"
+
+/**
+ * The entry points of the Vulkan renderer module.
+ */
+namespace Si::VulkanRenderer {
+
+void Initialize();
+void Deinitialize();
+
+/**
+ * The most frames either renderer lets the CPU record ahead of the GPU.
+ */
+constexpr std::uint32_t MaxFramesInFlight = 3;
+
+/**
+ * @brief Creates a renderer that presents to a window and registers it as "Si::Vulkan".
+ *
+ * @param window The window to present to.
+ * @param framesInFlight How many frames the CPU may record while the GPU is still rendering earlier ones, from 1 to MaxFramesInFlight.
+ * This is independent of how many images the swap chain has.
+ */
+void Create(Window &window, std::uint32_t framesInFlight = 2);
+
+/**
+ * @brief Creates a renderer that draws into offscreen images and registers it as "Si::Vulkan::Headless".
+ *
+ * It needs no window, surface or display, so it runs on machines with only a software Vulkan driver. Read each frame back with
+ * Renderer::GetPixels().
+ *
+ * @param width The width of the rendered images in pixels.
+ * @param height The height of the rendered images in pixels.
+ * @param framesInFlight How many frames may render while earlier ones are read back, from 1 to MaxFramesInFlight.
+ * @return Whether the renderer was created. False when there is no Vulkan driver or no device, in which case nothing is registered.
+ */
+bool CreateHeadless(std::uint32_t width, std::uint32_t height, std::uint32_t framesInFlight = 2);
+
+}
+
+#endif // SILICON_VULKANRENDERER_HPP
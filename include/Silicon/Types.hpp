@@ -36,8 +36,10 @@
 
 #include "boost/graph/adjacency_list.hpp"
 #include "gsl/pointers"
+#include "gsl/span"
 
 #include "Allocator.hpp"
+#include "MemoryResource.hpp"
 
 namespace Si {
 
@@ -48,23 +50,89 @@ using NotNull = gsl::not_null<T>;
 using NotNull = gsl::strict_not_null<T>;
 #endif
 
+/**
+ * A non-owning view over a contiguous sequence of objects.
+ */
+template <typename T>
+using Span = gsl::span<T>;
+
+/**
+ * Containers with a Silicon allocator whose memory is accounted to a subsystem.
+ *
+ * @tparam Tag The subsystem the containers' memory is accounted to.
+ */
+template <MemoryTag Tag>
+struct Tagged {
+    template <typename T>
+    using Vector = std::vector<T, Allocator<T, Tag>>;
+
+    template <typename T>
+    using List = std::list<T, Allocator<T, Tag>>;
+
+    template <typename Key, typename Value, typename Compare = std::less<Key>>
+    using Map = std::map<Key, Value, Compare, Allocator<std::pair<const Key, Value>, Tag>>;
+
+    template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    using HashMap = std::unordered_map<Key, Value, Hash, KeyEqual, Allocator<std::pair<const Key, Value>, Tag>>;
+};
+
 template <typename T>
-using Vector = std::vector<T, Allocator<T>>;
+using Vector = Tagged<MemoryTag::General>::Vector<T>;
 
 template <typename T>
-using List = std::list<T, Allocator<T>>;
+using List = Tagged<MemoryTag::General>::List<T>;
 
 /**
  * A STL map with a Silicon allocator.
  */
 template <typename Key, typename Value, typename Compare = std::less<Key>>
-using Map = std::map<Key, Value, Compare, Allocator<std::pair<const Key, Value>>>;
+using Map = Tagged<MemoryTag::General>::Map<Key, Value, Compare>;
 
 /**
  * A STL unordered map with a Silicon allocator.
  */
 template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
-using HashMap = std::unordered_map<Key, Value, Hash, KeyEqual, Allocator<std::pair<const Key, Value>>>;
+using HashMap = Tagged<MemoryTag::General>::HashMap<Key, Value, Hash, KeyEqual>;
+
+/**
+ * A vector allocated from the calling thread's frame arena. Must not outlive the current frame.
+ */
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+/**
+ * A vector for data owned by a single worker task. Allocations do not take a lock.
+ */
+template <typename T>
+using ThreadLocalVector = std::vector<T, ThreadLocalAllocator<T>>;
+
+namespace pmr {
+
+    /**
+     * A vector whose memory resource is chosen at runtime.
+     */
+    template <typename T>
+    using Vector = std::vector<T, PolymorphicAllocator<T>>;
+
+    /**
+     * A list whose memory resource is chosen at runtime.
+     */
+    template <typename T>
+    using List = std::list<T, PolymorphicAllocator<T>>;
+
+    /**
+     * A STL map whose memory resource is chosen at runtime.
+     */
+    template <typename Key, typename Value, typename Compare = std::less<Key>>
+    using Map = std::map<Key, Value, Compare, PolymorphicAllocator<std::pair<const Key, Value>>>;
+
+    /**
+     * A STL unordered map whose memory resource is chosen at runtime.
+     */
+    template <typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+    using HashMap = std::unordered_map<Key, Value, Hash, KeyEqual, PolymorphicAllocator<std::pair<const Key, Value>>>;
+
+}
 
 /**
  * Vector for use in Graphs.
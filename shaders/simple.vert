@@ -3,9 +3,12 @@
 layout(location = 0) in vec2 inPosition;
 layout(location = 1) in vec3 inColor;
 
+layout(location = 2) in vec2 inInstanceOffset;
+layout(location = 3) in vec3 inInstanceTint;
+
 layout(location = 0) out vec3 fragColor;
 
 void main() {
-    gl_Position = vec4(inPosition, 0.0, 1.0);
-    fragColor = inColor;
+    gl_Position = vec4(inPosition + inInstanceOffset, 0.0, 1.0);
+    fragColor = inColor * inInstanceTint;
 }
\ No newline at end of file
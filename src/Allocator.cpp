@@ -0,0 +1,280 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/21/23.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "boost/assert.hpp"
+
+#include "Silicon/Allocator.hpp"
+
+namespace {
+
+constexpr std::size_t AlignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Aligns the address of an offset into a block, rather than the offset itself.
+std::size_t AlignOffset(const std::uint8_t *base, std::size_t offset, std::size_t alignment)
+{
+    auto address = reinterpret_cast<std::uintptr_t>(base) + offset;
+    return AlignUp(address, alignment) - reinterpret_cast<std::uintptr_t>(base);
+}
+
+struct FrameArena {
+    Si::Arena arena;
+
+    FrameArena();
+    ~FrameArena();
+};
+
+std::mutex s_frameArenasMutex;
+std::vector<Si::Arena *> s_frameArenas;
+
+FrameArena::FrameArena()
+{
+    std::lock_guard<std::mutex> lock(s_frameArenasMutex);
+    s_frameArenas.push_back(&arena);
+}
+
+FrameArena::~FrameArena()
+{
+    std::lock_guard<std::mutex> lock(s_frameArenasMutex);
+    s_frameArenas.erase(std::find(s_frameArenas.begin(), s_frameArenas.end(), &arena));
+}
+
+constexpr std::size_t PoolGranularity = alignof(std::max_align_t);
+constexpr std::size_t PoolClassCount = 16;
+constexpr std::size_t PoolMaxSize = PoolGranularity * PoolClassCount;
+constexpr std::size_t PoolChunkSize = 64 * 1024;
+
+struct FreeBlock {
+    FreeBlock *next;
+};
+
+// Blocks may move between threads' free lists, so chunks are kept until the process exits.
+struct PoolChunks {
+    std::mutex mutex;
+    std::vector<void *> chunks;
+
+    ~PoolChunks()
+    {
+        for (void *chunk : chunks) {
+            ::operator delete(chunk);
+        }
+    }
+};
+
+PoolChunks s_poolChunks;
+
+struct ThreadPools {
+    FreeBlock *freeLists[PoolClassCount] {};
+
+    FreeBlock *refill(std::size_t sizeClass)
+    {
+        std::size_t blockSize = (sizeClass + 1) * PoolGranularity;
+        std::size_t blockCount = PoolChunkSize / blockSize;
+        auto *chunk = static_cast<std::uint8_t *>(::operator new(blockCount * blockSize));
+
+        {
+            std::lock_guard<std::mutex> lock(s_poolChunks.mutex);
+            s_poolChunks.chunks.push_back(chunk);
+        }
+
+        FreeBlock *head = nullptr;
+
+        for (std::size_t i = blockCount; i-- > 1;) {
+            auto *block = reinterpret_cast<FreeBlock *>(chunk + i * blockSize);
+            block->next = head;
+            head = block;
+        }
+
+        freeLists[sizeClass] = head;
+        return reinterpret_cast<FreeBlock *>(chunk);
+    }
+};
+
+thread_local ThreadPools t_pools;
+
+}
+
+namespace Si {
+
+struct Arena::Block {
+    Block *next;
+    std::size_t size;
+
+    static constexpr std::size_t HeaderSize = AlignUp(sizeof(Block *) + sizeof(std::size_t), alignof(std::max_align_t));
+
+    std::uint8_t *data()
+    {
+        return reinterpret_cast<std::uint8_t *>(this) + HeaderSize;
+    }
+};
+
+Arena::Arena(std::size_t blockSize)
+    : m_blockSize(blockSize)
+{
+}
+
+Arena::~Arena()
+{
+    while (m_blocks) {
+        Block *next = m_blocks->next;
+        ::operator delete(m_blocks);
+        m_blocks = next;
+    }
+}
+
+void *Arena::Allocate(std::size_t size, std::size_t alignment)
+{
+    BOOST_ASSERT_MSG((alignment & (alignment - 1)) == 0, "Alignment must be a power of two");
+
+    if (m_current) {
+        std::size_t offset = AlignOffset(m_current->data(), m_offset, alignment);
+
+        if (offset + size <= m_current->size) {
+            m_offset = offset + size;
+            m_used += size;
+            return m_current->data() + offset;
+        }
+    }
+
+    // Blocks are aligned to max_align_t; larger alignments may need padding at the start.
+    std::size_t required = size + (alignment > alignof(std::max_align_t) ? alignment : 0);
+    Block *previous = m_current;
+    Block *block = m_current ? m_current->next : m_blocks;
+
+    // Reuse blocks kept from before the last reset, dropping any that are too small.
+    while (block && block->size < required) {
+        Block *next = block->next;
+        ::operator delete(block);
+        block = next;
+    }
+
+    if (!block) {
+        std::size_t blockSize = std::max(m_blockSize, required);
+        block = static_cast<Block *>(::operator new(Block::HeaderSize + blockSize));
+        block->next = nullptr;
+        block->size = blockSize;
+    }
+
+    if (previous) {
+        previous->next = block;
+    } else {
+        m_blocks = block;
+    }
+
+    m_current = block;
+
+    std::size_t offset = AlignOffset(block->data(), 0, alignment);
+    m_offset = offset + size;
+    m_used += size;
+
+    return block->data() + offset;
+}
+
+void Arena::Reset()
+{
+    m_current = m_blocks;
+    m_offset = 0;
+    m_used = 0;
+}
+
+std::size_t Arena::GetUsed() const
+{
+    return m_used;
+}
+
+std::size_t Arena::GetCapacity() const
+{
+    std::size_t capacity = 0;
+
+    for (Block *block = m_blocks; block; block = block->next) {
+        capacity += block->size;
+    }
+
+    return capacity;
+}
+
+Arena &GetFrameArena()
+{
+    thread_local FrameArena frameArena;
+    return frameArena.arena;
+}
+
+void ResetFrameArenas()
+{
+    std::lock_guard<std::mutex> lock(s_frameArenasMutex);
+
+    for (Arena *arena : s_frameArenas) {
+        arena->Reset();
+    }
+}
+
+void *ThreadLocalAllocate(std::size_t size)
+{
+    if (size == 0 || size > PoolMaxSize) {
+        return ::operator new(size);
+    }
+
+    std::size_t sizeClass = (size - 1) / PoolGranularity;
+    FreeBlock *block = t_pools.freeLists[sizeClass];
+
+    if (!block) {
+        return t_pools.refill(sizeClass);
+    }
+
+    t_pools.freeLists[sizeClass] = block->next;
+    return block;
+}
+
+void ThreadLocalFree(void *pointer, std::size_t size)
+{
+    if (!pointer) {
+        return;
+    }
+
+    if (size == 0 || size > PoolMaxSize) {
+        ::operator delete(pointer);
+        return;
+    }
+
+    std::size_t sizeClass = (size - 1) / PoolGranularity;
+    auto *block = static_cast<FreeBlock *>(pointer);
+    block->next = t_pools.freeLists[sizeClass];
+    t_pools.freeLists[sizeClass] = block;
+}
+
+}
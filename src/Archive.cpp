@@ -0,0 +1,492 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/17/23.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "boost/assert.hpp"
+
+#include "Silicon/Archive.hpp"
+#include "Silicon/Log.hpp"
+
+namespace {
+
+static_assert(sizeof(Si::Archive::Header) == 32);
+static_assert(sizeof(Si::Archive::Entry) == 48);
+
+constexpr std::size_t MinMatch = 4;
+constexpr std::size_t MaxOffset = 65535;
+constexpr std::size_t HashBits = 12;
+
+std::shared_mutex &GetMountMutex()
+{
+    static std::shared_mutex mutex;
+    return mutex;
+}
+
+Si::Vector<std::shared_ptr<Si::Archive>> &GetMounted()
+{
+    static Si::Vector<std::shared_ptr<Si::Archive>> mounted;
+    return mounted;
+}
+
+std::uint32_t Read32(const std::uint8_t *p)
+{
+    std::uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+void WriteLength(Si::Vector<std::uint8_t> &out, std::size_t length)
+{
+    for (; length >= 255; length -= 255) {
+        out.push_back(255);
+    }
+
+    out.push_back(static_cast<std::uint8_t>(length));
+}
+
+/*
+ * Each sequence is a token, its literal bytes, then a match. The token's high nibble is the literal count and its low nibble the match
+ * length minus MinMatch, with 15 meaning more length bytes follow. A match is a 16-bit offset back into the output. The final sequence
+ * is literals only.
+ */
+void EmitSequence(Si::Vector<std::uint8_t> &out, const std::uint8_t *literals, std::size_t literalCount, std::size_t offset, std::size_t matchLength)
+{
+    std::size_t matchCode = matchLength ? matchLength - MinMatch : 0;
+
+    out.push_back(static_cast<std::uint8_t>((std::min<std::size_t>(literalCount, 15) << 4) | std::min<std::size_t>(matchCode, 15)));
+
+    if (literalCount >= 15) {
+        WriteLength(out, literalCount - 15);
+    }
+
+    out.insert(out.end(), literals, literals + literalCount);
+
+    if (!matchLength) {
+        return;
+    }
+
+    out.push_back(static_cast<std::uint8_t>(offset));
+    out.push_back(static_cast<std::uint8_t>(offset >> 8));
+
+    if (matchCode >= 15) {
+        WriteLength(out, matchCode - 15);
+    }
+}
+
+Si::Vector<std::uint8_t> Compress(Si::Span<const std::uint8_t> in)
+{
+    Si::Vector<std::uint8_t> out;
+    out.reserve(in.size() + in.size() / 255 + 16);
+
+    // Positions are stored plus one so zero means empty.
+    Si::Vector<std::uint32_t> table(std::size_t(1) << HashBits, 0);
+
+    const std::uint8_t *data = in.data();
+    std::size_t size = in.size();
+    std::size_t anchor = 0;
+    std::size_t i = 0;
+
+    while (i + MinMatch <= size) {
+        std::uint32_t sequence = Read32(data + i);
+        std::uint32_t &slot = table[(sequence * 2654435761u) >> (32 - HashBits)];
+        std::size_t candidate = slot;
+        slot = static_cast<std::uint32_t>(i + 1);
+
+        if (!candidate || i - (candidate - 1) > MaxOffset || Read32(data + candidate - 1) != sequence) {
+            i++;
+            continue;
+        }
+
+        candidate--;
+
+        std::size_t length = MinMatch;
+        while (i + length < size && data[candidate + length] == data[i + length]) {
+            length++;
+        }
+
+        EmitSequence(out, data + anchor, i - anchor, i - candidate, length);
+
+        i += length;
+        anchor = i;
+    }
+
+    EmitSequence(out, data + anchor, size - anchor, 0, 0);
+
+    return out;
+}
+
+std::size_t ReadLength(const std::uint8_t *&in, const std::uint8_t *end, std::size_t length, bool &ok)
+{
+    if (length != 15) {
+        return length;
+    }
+
+    std::uint8_t byte;
+    do {
+        if (in == end) {
+            ok = false;
+            return 0;
+        }
+
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+
+    return length;
+}
+
+bool Decompress(Si::Span<const std::uint8_t> in, std::uint8_t *out, std::size_t outSize)
+{
+    const std::uint8_t *ip = in.data();
+    const std::uint8_t *end = ip + in.size();
+    std::size_t op = 0;
+    bool ok = true;
+
+    while (ip < end) {
+        std::uint8_t token = *ip++;
+
+        std::size_t literalCount = ReadLength(ip, end, token >> 4, ok);
+        if (!ok || literalCount > static_cast<std::size_t>(end - ip) || literalCount > outSize - op) {
+            return false;
+        }
+
+        std::memcpy(out + op, ip, literalCount);
+        ip += literalCount;
+        op += literalCount;
+
+        if (ip == end) {
+            break;
+        }
+
+        if (end - ip < 2) {
+            return false;
+        }
+
+        std::size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        std::size_t matchLength = ReadLength(ip, end, token & 15, ok) + MinMatch;
+        if (!ok || offset == 0 || offset > op || matchLength > outSize - op) {
+            return false;
+        }
+
+        // Matches may overlap the bytes they produce, so copy forwards one byte at a time.
+        for (std::size_t i = 0; i < matchLength; i++, op++) {
+            out[op] = out[op - offset];
+        }
+    }
+
+    return op == outSize;
+}
+
+std::uint64_t AlignUp(std::uint64_t value, std::uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}
+
+namespace Si {
+
+Archive::Archive(std::string path)
+    : Asset(std::move(path), Storage::Mapped)
+{
+    Span<const std::uint8_t> bytes = GetBytes();
+
+    auto fail = [this](const char *reason) {
+        Engine::Error("Invalid archive {}: {}", GetPath(), reason);
+        throw std::runtime_error("Invalid archive " + GetPath() + ": " + reason);
+    };
+
+    if (bytes.size() < sizeof(Header)) {
+        fail("too small");
+    }
+
+    Header header {};
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if (header.magic != Magic) {
+        fail("not an archive");
+    }
+
+    if (header.version != Version) {
+        fail("unsupported version");
+    }
+
+    if (header.slotCount == 0 || (header.slotCount & (header.slotCount - 1)) || header.tableOffset % alignof(Entry) ||
+        header.tableOffset > bytes.size() || (bytes.size() - header.tableOffset) / sizeof(Entry) < header.slotCount ||
+        header.stringsOffset > bytes.size()) {
+        fail("corrupt entry table");
+    }
+
+    m_entries = Span<const Entry>(reinterpret_cast<const Entry *>(bytes.data() + header.tableOffset), header.slotCount);
+    m_strings = std::string_view(reinterpret_cast<const char *>(bytes.data() + header.stringsOffset), bytes.size() - header.stringsOffset);
+
+    std::size_t emptySlots = 0;
+
+    for (const Entry &entry : m_entries) {
+        if (entry.pathLength == 0) {
+            emptySlots++;
+            continue;
+        }
+
+        if (entry.pathOffset > m_strings.size() || entry.pathLength > m_strings.size() - entry.pathOffset ||
+            entry.offset > bytes.size() || entry.size > bytes.size() - entry.offset ||
+            (entry.compression == Compression::None && entry.size != entry.originalSize) || entry.compression > Compression::LZ) {
+            fail("corrupt entry");
+        }
+    }
+
+    // Find probes until it reaches an empty slot, so a full table would never end a lookup for a missing path.
+    if (!emptySlots) {
+        fail("corrupt entry table");
+    }
+
+    Engine::Trace("Opened archive {} with {} entries", GetPath(), header.entryCount);
+}
+
+const Archive::Entry *Archive::Find(std::string_view path) const
+{
+    std::uint64_t hash = Hash(path);
+    std::size_t mask = m_entries.size() - 1;
+
+    for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+        const Entry &entry = m_entries[i];
+
+        // The writer always leaves empty slots, so probing terminates.
+        if (entry.pathLength == 0) {
+            return nullptr;
+        }
+
+        if (entry.pathHash == hash && GetEntryPath(entry) == path) {
+            return &entry;
+        }
+    }
+}
+
+Span<const std::uint8_t> Archive::GetStoredBytes(const Entry &entry) const
+{
+    return GetBytes().subspan(entry.offset, entry.size);
+}
+
+void Archive::Extract(const Entry &entry, Tagged<MemoryTag::Assets>::Vector<std::uint8_t> &out) const
+{
+    Span<const std::uint8_t> stored = GetStoredBytes(entry);
+    out.resize(entry.originalSize);
+
+    if (entry.compression == Compression::None) {
+        std::copy(stored.begin(), stored.end(), out.begin());
+        return;
+    }
+
+    if (!Decompress(stored, out.data(), out.size())) {
+        Engine::Error("Failed to decompress {} from archive {}", GetEntryPath(entry), GetPath());
+        throw std::runtime_error("Failed to decompress " + std::string(GetEntryPath(entry)) + " from archive " + GetPath());
+    }
+}
+
+std::string_view Archive::GetEntryPath(const Entry &entry) const
+{
+    return m_strings.substr(entry.pathOffset, entry.pathLength);
+}
+
+std::size_t Archive::GetEntryCount() const
+{
+    return std::count_if(m_entries.begin(), m_entries.end(), [](const Entry &entry) { return entry.pathLength != 0; });
+}
+
+std::shared_ptr<Archive> Archive::Mount(const std::string &path)
+{
+    auto archive = Asset::GetNow<Archive>(path);
+
+    std::unique_lock lock(GetMountMutex());
+    auto &mounted = GetMounted();
+
+    if (std::find(mounted.begin(), mounted.end(), archive) == mounted.end()) {
+        mounted.push_back(archive);
+        Engine::Debug("Mounted archive {}", path);
+    }
+
+    return archive;
+}
+
+void Archive::Unmount(const std::string &path)
+{
+    std::unique_lock lock(GetMountMutex());
+    auto &mounted = GetMounted();
+
+    mounted.erase(std::remove_if(mounted.begin(), mounted.end(), [&path](const std::shared_ptr<Archive> &archive) {
+        return archive->GetPath() == path;
+    }), mounted.end());
+}
+
+std::shared_ptr<const Archive> Archive::Resolve(std::string_view path, const Entry *&entry)
+{
+    std::shared_lock lock(GetMountMutex());
+    auto &mounted = GetMounted();
+
+    for (auto archive = mounted.rbegin(); archive != mounted.rend(); ++archive) {
+        if ((entry = (*archive)->Find(path))) {
+            return *archive;
+        }
+    }
+
+    return nullptr;
+}
+
+std::uint64_t Archive::Hash(std::string_view path)
+{
+    // 64-bit FNV-1a.
+    std::uint64_t hash = 14695981039346656037ull;
+
+    for (char c : path) {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+void ArchiveWriter::Add(std::string path, Span<const std::uint8_t> bytes, Archive::Compression compression)
+{
+    BOOST_ASSERT_MSG(!path.empty(), "Archive entries must have a path!");
+
+    PendingEntry entry {std::move(path), {}, bytes.size(), Archive::Compression::None};
+
+    if (compression == Archive::Compression::LZ) {
+        entry.bytes = Compress(bytes);
+
+        if (entry.bytes.size() < bytes.size()) {
+            entry.compression = compression;
+        } else {
+            entry.bytes.clear();
+        }
+    }
+
+    if (entry.compression == Archive::Compression::None) {
+        entry.bytes.assign(bytes.begin(), bytes.end());
+    }
+
+    m_entries.push_back(std::move(entry));
+}
+
+bool ArchiveWriter::Write(const std::string &path) const
+{
+    // Keep the table at most half full so lookups of missing paths stop quickly.
+    std::uint32_t slotCount = 1;
+    while (slotCount < m_entries.size() * 2) {
+        slotCount *= 2;
+    }
+
+    Vector<Archive::Entry> table(slotCount, Archive::Entry {});
+    std::string strings;
+
+    Archive::Header header {};
+    header.magic = Archive::Magic;
+    header.version = Archive::Version;
+    header.entryCount = static_cast<std::uint32_t>(m_entries.size());
+    header.slotCount = slotCount;
+    header.tableOffset = sizeof(Archive::Header);
+
+    std::uint64_t stringsSize = 0;
+    for (const PendingEntry &pending : m_entries) {
+        stringsSize += pending.path.size();
+    }
+
+    header.stringsOffset = header.tableOffset + slotCount * sizeof(Archive::Entry);
+    std::uint64_t offset = AlignUp(header.stringsOffset + stringsSize, Archive::Alignment);
+
+    for (const PendingEntry &pending : m_entries) {
+        std::uint64_t hash = Archive::Hash(pending.path);
+        std::size_t mask = slotCount - 1;
+        std::size_t i = hash & mask;
+
+        while (table[i].pathLength != 0) {
+            if (table[i].pathHash == hash && std::string_view(strings).substr(table[i].pathOffset, table[i].pathLength) == pending.path) {
+                Engine::Error("Duplicate archive entry: {}", pending.path);
+                return false;
+            }
+
+            i = (i + 1) & mask;
+        }
+
+        Archive::Entry &entry = table[i];
+        entry.pathHash = hash;
+        entry.offset = offset;
+        entry.size = pending.bytes.size();
+        entry.originalSize = pending.originalSize;
+        entry.pathOffset = static_cast<std::uint32_t>(strings.size());
+        entry.pathLength = static_cast<std::uint32_t>(pending.path.size());
+        entry.compression = pending.compression;
+
+        strings += pending.path;
+        offset = AlignUp(offset + entry.size, Archive::Alignment);
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        Engine::Error("Failed to open archive for writing: {}", path);
+        return false;
+    }
+
+    auto pad = [&file](std::uint64_t position) {
+        static const char zeros[Archive::Alignment] {};
+        std::uint64_t padding = AlignUp(position, Archive::Alignment) - position;
+        file.write(zeros, static_cast<std::streamsize>(padding));
+    };
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(table.data()), static_cast<std::streamsize>(table.size() * sizeof(Archive::Entry)));
+    file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+    pad(header.stringsOffset + strings.size());
+
+    // Blobs are written in the order they were added, which is also the order their offsets were assigned.
+    for (const PendingEntry &pending : m_entries) {
+        file.write(reinterpret_cast<const char *>(pending.bytes.data()), static_cast<std::streamsize>(pending.bytes.size()));
+        pad(pending.bytes.size());
+    }
+
+    if (!file) {
+        Engine::Error("Failed to write archive: {}", path);
+        return false;
+    }
+
+    return true;
+}
+
+}
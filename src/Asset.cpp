@@ -28,29 +28,574 @@
 // Created by Matthew McCall on 1/7/23.
 //
 
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
 #include <utility>
 
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#elif (defined(__unix__) || defined(__APPLE__)) && !defined(__EMSCRIPTEN__)
+// Emscripten's mmap() copies the file into memory anyway, so it reads instead.
+#define SI_ASSET_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "SDL_rwops.h"
 
+#include "Silicon/Archive.hpp"
 #include "Silicon/Asset.hpp"
 
+namespace {
+
+// Loads spend most of their time blocked on the filesystem, so there are more I/O threads than a single disk strictly needs.
+constexpr std::size_t IOThreadCount = 4;
+
+constexpr std::size_t DefaultCacheBudget = 256 * 1024 * 1024;
+
+}
+
 namespace Si {
 
+struct Asset::Load {
+    enum class State
+    {
+        Queued,
+        Loading,
+        Done
+    };
+
+    Load(std::string assetPath, Loader assetLoader, Priority loadPriority)
+        : path(std::move(assetPath))
+        , loader(assetLoader)
+        , priority(loadPriority)
+        , result(promise.get_future().share())
+    {
+    }
+
+    std::string path;
+    Loader loader;
+
+    // Guarded by Streamer::mutex.
+    Priority priority;
+    State state = State::Queued;
+    std::size_t interest = 0;
+
+    std::promise<std::shared_ptr<Asset>> promise;
+    std::shared_future<std::shared_ptr<Asset>> result;
+};
+
+struct Asset::Streamer {
+    // The size is recorded so the budget stays balanced even if an asset's resident size changes.
+    struct RetainedAsset {
+        std::shared_ptr<Asset> asset;
+        std::size_t size;
+    };
+
+    using Retained = Tagged<MemoryTag::Assets>::List<RetainedAsset>;
+
+    struct CachedAsset {
+        std::weak_ptr<Asset> asset;
+        Retained::iterator retained;
+        bool isRetained = false;
+    };
+
+    struct QueuedLoad {
+        Priority priority;
+        std::uint64_t sequence;
+        std::shared_ptr<Load> load;
+
+        bool operator<(const QueuedLoad &other) const
+        {
+            if (priority != other.priority) {
+                return priority < other.priority;
+            }
+
+            // Earlier requests come first among equal priorities.
+            return sequence > other.sequence;
+        }
+    };
+
+    ~Streamer()
+    {
+        shutdown();
+    }
+
+    /**
+     * Finds a loaded or in-flight asset. Must be called with the mutex held.
+     *
+     * @param evicted Receives assets evicted to make room, to be released after the mutex is.
+     */
+    std::shared_ptr<Load> find(const std::string &path, Loader loader, Vector<std::shared_ptr<Asset>> &evicted)
+    {
+        if (auto cached = loaded.find(path); cached != loaded.end()) {
+            if (auto asset = cached->second.asset.lock()) {
+                stats.hits++;
+                retain(cached->second, asset, evicted);
+
+                auto load = std::make_shared<Load>(path, loader, Priority::Normal);
+                load->state = Load::State::Done;
+                load->promise.set_value(std::move(asset));
+                return load;
+            }
+
+            Engine::Trace("Cache miss for asset: {}", path);
+            loaded.erase(cached);
+        }
+
+        if (auto load = inFlight.find(path); load != inFlight.end()) {
+            stats.hits++;
+            return load->second;
+        }
+
+        stats.misses++;
+        return nullptr;
+    }
+
+    /**
+     * Marks an asset as the most recently used, keeping it resident after its last user releases it. Must be called with the mutex held.
+     */
+    void retain(CachedAsset &cached, const std::shared_ptr<Asset> &asset, Vector<std::shared_ptr<Asset>> &evicted)
+    {
+        if (cached.isRetained) {
+            retained.splice(retained.begin(), retained, cached.retained);
+            return;
+        }
+
+        std::size_t size = asset->GetResidentSize();
+
+        // Retaining it would only evict everything else.
+        if (size > budget) {
+            return;
+        }
+
+        retained.push_front({asset, size});
+        cached.retained = retained.begin();
+        cached.isRetained = true;
+
+        stats.residentBytes += size;
+        stats.residentCount++;
+
+        evict(budget, evicted);
+    }
+
+    /**
+     * Evicts the least recently used assets until no more than a number of bytes are retained. Must be called with the mutex held.
+     */
+    void evict(std::size_t bytes, Vector<std::shared_ptr<Asset>> &evicted)
+    {
+        while (stats.residentBytes > bytes) {
+            RetainedAsset &oldest = retained.back();
+
+            stats.residentBytes -= oldest.size;
+            stats.residentCount--;
+            stats.evictions++;
+
+            // Still tracked through its weak_ptr for as long as something else holds on to it.
+            loaded[oldest.asset->GetPath()].isRetained = false;
+
+            evicted.push_back(std::move(oldest.asset));
+            retained.pop_back();
+        }
+    }
+
+    /**
+     * Must be called with the mutex held.
+     */
+    void push(const std::shared_ptr<Load> &load)
+    {
+        queue.push({load->priority, sequence++, load});
+        queued.notify_one();
+
+        start();
+    }
+
+    /**
+     * Must be called with the mutex held.
+     */
+    void start()
+    {
+        if (!threads.empty() || stopping) {
+            return;
+        }
+
+        for (std::size_t i = 0; i < IOThreadCount; i++) {
+            threads.emplace_back([this]() { run(); });
+        }
+    }
+
+    /**
+     * Runs a load that has been moved to the Loading state, on the calling thread.
+     */
+    void execute(Load &load)
+    {
+        std::shared_ptr<Asset> asset;
+        std::exception_ptr error;
+        Vector<std::shared_ptr<Asset>> evicted;
+
+        try {
+            asset = load.loader(load.path);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard lock(mutex);
+
+            if (asset) {
+                CachedAsset &cached = loaded[load.path];
+                cached.asset = asset;
+                retain(cached, asset, evicted);
+            }
+
+            inFlight.erase(load.path);
+            load.state = Load::State::Done;
+        }
+
+        if (error) {
+            load.promise.set_exception(error);
+        } else {
+            load.promise.set_value(std::move(asset));
+        }
+    }
+
+    void run()
+    {
+        std::unique_lock lock(mutex);
+
+        while (true) {
+            queued.wait(lock, [this]() { return stopping || !queue.empty(); });
+
+            if (stopping) {
+                return;
+            }
+
+            std::shared_ptr<Load> load = queue.top().load;
+            queue.pop();
+
+            // Loads that were cancelled, taken over by GetNow(), or re-queued at a higher priority leave stale entries behind.
+            if (load->state != Load::State::Queued) {
+                continue;
+            }
+
+            load->state = Load::State::Loading;
+
+            lock.unlock();
+            execute(*load);
+            lock.lock();
+        }
+    }
+
+    void shutdown()
+    {
+        Vector<std::shared_ptr<Load>> cancelled;
+        Vector<std::thread> stopped;
+        Vector<std::shared_ptr<Asset>> evicted;
+
+        {
+            std::lock_guard lock(mutex);
+
+            evict(0, evicted);
+
+            for (auto i = inFlight.begin(); i != inFlight.end();) {
+                if (i->second->state == Load::State::Queued) {
+                    i->second->state = Load::State::Done;
+                    cancelled.push_back(std::move(i->second));
+                    i = inFlight.erase(i);
+                } else {
+                    ++i;
+                }
+            }
+
+            queue = {};
+            stopping = true;
+            stopped.swap(threads);
+        }
+
+        queued.notify_all();
+
+        for (std::thread &thread : stopped) {
+            thread.join();
+        }
+
+        for (auto &load : cancelled) {
+            load->promise.set_value(nullptr);
+        }
+
+        std::lock_guard lock(mutex);
+        stopping = false;
+
+        // Anything queued while the threads were stopping still needs to load.
+        if (!queue.empty()) {
+            start();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable queued;
+
+    Tagged<MemoryTag::Assets>::HashMap<std::string, CachedAsset> loaded;
+    Tagged<MemoryTag::Assets>::HashMap<std::string, std::shared_ptr<Load>> inFlight;
+
+    // Most recently used first.
+    Retained retained;
+    std::size_t budget = DefaultCacheBudget;
+    CacheStats stats {};
+
+    std::priority_queue<QueuedLoad, Tagged<MemoryTag::Assets>::Vector<QueuedLoad>> queue;
+    std::uint64_t sequence = 0;
+
+    Vector<std::thread> threads;
+    bool stopping = false;
+};
+
+Asset::Streamer &Asset::GetStreamer()
+{
+    static Streamer streamer;
+    return streamer;
+}
+
+std::shared_ptr<Asset> Asset::LoadNow(const std::string &asset_path, Loader loader)
+{
+    Streamer &streamer = GetStreamer();
+    Vector<std::shared_ptr<Asset>> evicted;
+    std::unique_lock lock(streamer.mutex);
+
+    std::shared_ptr<Load> load = streamer.find(asset_path, loader, evicted);
+
+    if (load && load->state != Load::State::Queued) {
+        lock.unlock();
+        return load->result.get();
+    }
+
+    // Rather than wait behind the I/O queue, take over a queued load and run it here.
+    if (!load) {
+        load = std::make_shared<Load>(asset_path, loader, Priority::Critical);
+        streamer.inFlight[asset_path] = load;
+    }
+
+    load->state = Load::State::Loading;
+    lock.unlock();
+
+    streamer.execute(*load);
+    return load->result.get();
+}
+
+std::shared_ptr<Asset::Load> Asset::Enqueue(const std::string &asset_path, Loader loader, Priority priority)
+{
+    Streamer &streamer = GetStreamer();
+    Vector<std::shared_ptr<Asset>> evicted;
+    std::lock_guard lock(streamer.mutex);
+
+    std::shared_ptr<Load> load = streamer.find(asset_path, loader, evicted);
+
+    if (!load) {
+        load = std::make_shared<Load>(asset_path, loader, priority);
+        streamer.inFlight[asset_path] = load;
+        streamer.push(load);
+    } else if (load->state == Load::State::Queued && priority > load->priority) {
+        load->priority = priority;
+        streamer.push(load);
+    }
+
+    load->interest++;
+    return load;
+}
+
+std::shared_ptr<Asset> Asset::Wait(Load &load)
+{
+    return load.result.get();
+}
+
+bool Asset::IsReady(Load &load)
+{
+    return load.result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void Asset::Cancel(Load &load)
+{
+    Streamer &streamer = GetStreamer();
+
+    {
+        std::lock_guard lock(streamer.mutex);
+
+        if (--load.interest > 0 || load.state != Load::State::Queued) {
+            return;
+        }
+
+        load.state = Load::State::Done;
+        streamer.inFlight.erase(load.path);
+    }
+
+    load.promise.set_value(nullptr);
+}
+
+std::size_t Asset::GetPendingCount()
+{
+    Streamer &streamer = GetStreamer();
+    std::lock_guard lock(streamer.mutex);
+
+    return streamer.inFlight.size();
+}
+
+void Asset::Shutdown()
+{
+    GetStreamer().shutdown();
+}
+
+Asset::CacheStats Asset::GetCacheStats()
+{
+    Streamer &streamer = GetStreamer();
+    std::lock_guard lock(streamer.mutex);
+
+    CacheStats stats = streamer.stats;
+    stats.budget = streamer.budget;
+    return stats;
+}
+
+void Asset::SetCacheBudget(std::size_t bytes)
+{
+    Streamer &streamer = GetStreamer();
+    Vector<std::shared_ptr<Asset>> evicted;
+    std::lock_guard lock(streamer.mutex);
+
+    streamer.budget = bytes;
+    streamer.evict(bytes, evicted);
+}
+
 const std::string &Asset::GetPath() const
 {
     return m_path;
 }
 
-Vector<std::uint8_t> &Asset::GetBytes()
+Span<const std::uint8_t> Asset::GetBytes() const
+{
+    return m_bytes;
+}
+
+std::size_t Asset::GetResidentSize() const
 {
-    return m_data;
+    return m_bytes.size();
 }
 
-Asset::Asset(std::string path)
+Asset::Storage Asset::GetStorage() const
+{
+    return m_mapping || m_archive ? Storage::Mapped : Storage::Read;
+}
+
+Asset::Asset(std::string path, Storage storage)
     : m_path(std::move(path))
 {
     Engine::Trace("Loading asset: {}", m_path);
 
+    if (loadArchived(storage)) {
+        return;
+    }
+
+    if (storage == Storage::Mapped && map()) {
+        return;
+    }
+
+    read();
+}
+
+bool Asset::loadArchived(Storage storage)
+{
+    const Archive::Entry *entry = nullptr;
+    std::shared_ptr<const Archive> archive = Archive::Resolve(m_path, entry);
+
+    if (!archive) {
+        return false;
+    }
+
+    if (storage == Storage::Mapped && entry->compression == Archive::Compression::None && archive->GetStorage() == Storage::Mapped) {
+        // Holding on to the archive keeps its mapping alive.
+        m_archive = std::move(archive);
+        m_bytes = m_archive->GetStoredBytes(*entry);
+        return true;
+    }
+
+    archive->Extract(*entry, m_data);
+    m_bytes = Span<const std::uint8_t>(m_data.data(), m_data.size());
+    return true;
+}
+
+bool Asset::map()
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(m_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        // Empty files cannot be mapped.
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (!mapping) {
+        Engine::Warn("Failed to map file, reading it instead: {}", m_path);
+        return false;
+    }
+
+    // The view keeps the mapping alive after its handle is closed.
+    m_mapping = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (!m_mapping) {
+        Engine::Warn("Failed to map file, reading it instead: {}", m_path);
+        return false;
+    }
+
+    m_bytes = Span<const std::uint8_t>(static_cast<const std::uint8_t *>(m_mapping), static_cast<std::size_t>(size.QuadPart));
+    return true;
+#elif defined(SI_ASSET_MMAP)
+    int file = open(m_path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+
+    struct stat status { };
+    if (fstat(file, &status) != 0 || status.st_size == 0) {
+        // Empty files cannot be mapped.
+        close(file);
+        return false;
+    }
+
+    auto size = static_cast<std::size_t>(status.st_size);
+    void *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    // The mapping keeps the file open.
+    close(file);
+
+    if (address == MAP_FAILED) {
+        Engine::Warn("Failed to map file, reading it instead: {}", m_path);
+        return false;
+    }
+
+    m_mapping = address;
+    m_bytes = Span<const std::uint8_t>(static_cast<const std::uint8_t *>(address), size);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Asset::read()
+{
     // Load entire file into m_data using SDL.
     SDL_RWops *file = SDL_RWFromFile(m_path.c_str(), "rb");
     if (!file)
@@ -63,6 +608,7 @@ Asset::Asset(std::string path)
     Sint64 size = SDL_RWsize(file);
     if (size < 0)
     {
+        SDL_RWclose(file);
         Engine::Error("Failed to get file size: {}", m_path);
         throw std::runtime_error("Failed to get file size: " + m_path);
     }
@@ -71,29 +617,40 @@ Asset::Asset(std::string path)
     m_data.resize(static_cast<std::size_t>(size));
     std::size_t read = SDL_RWread(file, m_data.data(), 1, static_cast<std::size_t>(size));
 
+    SDL_RWclose(file);
+
     if (read != static_cast<std::size_t>(size))
     {
         Engine::Error("Failed to read file: {}", m_path);
         throw std::runtime_error("Failed to read file: " + m_path);
     }
 
-    SDL_RWclose(file);
+    m_bytes = Span<const std::uint8_t>(m_data.data(), m_data.size());
 }
 
 Asset::~Asset()
 {
     Engine::Trace("Unloading asset: {}", m_path);
+
+    if (!m_mapping) {
+        return;
+    }
+
+#if defined(_WIN32)
+    UnmapViewOfFile(m_mapping);
+#elif defined(SI_ASSET_MMAP)
+    munmap(m_mapping, m_bytes.size());
+#endif
 }
 
-PlainTextAsset::PlainTextAsset(std::string path)
-    : Asset(std::move(path))
+PlainTextAsset::PlainTextAsset(std::string path, Storage storage)
+    : Asset(std::move(path), storage)
 {
-    // Convert m_data to a string.
-    m_text = std::string(m_data.begin(), m_data.end());
 }
 
-const std::string &PlainTextAsset::GetText() const
+std::string_view PlainTextAsset::GetText() const
 {
-    return m_text;
+    Span<const std::uint8_t> bytes = GetBytes();
+    return {reinterpret_cast<const char *>(bytes.data()), bytes.size()};
+}
 }
-}
\ No newline at end of file
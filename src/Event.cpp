@@ -28,14 +28,35 @@
 // Created by Matthew McCall on 11/19/22.
 //
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 #include "SDL.h"
 
 #include "Silicon/Event.hpp"
 
+namespace {
+
+std::atomic<std::thread::id> s_processThread;
+std::mutex s_queuesMutex;
+
+using QueueList = Si::Tagged<Si::MemoryTag::Events>::Vector<Si::NotNull<Si::Event::QueueBase *>>;
+
+QueueList &GetQueues()
+{
+    static QueueList queues;
+    return queues;
+}
+
+}
+
 namespace Si::Event {
 
 void Process()
 {
+    s_processThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
     SDL_Event e;
     while (SDL_PollEvent(&e)) {
         switch (e.type) {
@@ -44,6 +65,47 @@ void Process()
             break;
         }
     }
+
+    QueueList &queues = GetQueues();
+
+    // Indexed and unlocked while dispatching, since a handler may enqueue a type of event that has never been queued before.
+    for (std::size_t i = 0;; i++) {
+        QueueBase *queue;
+
+        {
+            std::lock_guard<std::mutex> lock(s_queuesMutex);
+
+            if (i >= queues.size()) {
+                break;
+            }
+
+            queue = queues[i];
+        }
+
+        queue->dispatch();
+    }
+}
+
+void RegisterQueue(QueueBase &queue)
+{
+    std::lock_guard<std::mutex> lock(s_queuesMutex);
+    GetQueues().push_back(NotNull<QueueBase *>(&queue));
+}
+
+void UnregisterQueue(QueueBase &queue)
+{
+    std::lock_guard<std::mutex> lock(s_queuesMutex);
+    QueueList &queues = GetQueues();
+    auto i = std::find(queues.begin(), queues.end(), &queue);
+
+    if (i != queues.end()) {
+        queues.erase(i);
+    }
+}
+
+bool IsProcessThread()
+{
+    return s_processThread.load(std::memory_order_relaxed) == std::this_thread::get_id();
 }
 
 }
\ No newline at end of file
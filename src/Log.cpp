@@ -30,6 +30,7 @@
 #include "spdlog/sinks/ringbuffer_sink.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 
+#include "Silicon/Allocator.hpp"
 #include "Silicon/Config.hpp"
 #include "Silicon/Localization.hpp"
 #include "Silicon/Log.hpp"
@@ -55,19 +56,21 @@ public:
 private:
     LoggerManager()
     {
-        s_engineLogHistory = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(64);
-        s_clientLogHistory = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(64);
+        Si::Allocator<char, Si::MemoryTag::Logging> allocator;
+
+        s_engineLogHistory = std::allocate_shared<spdlog::sinks::ringbuffer_sink_mt>(allocator, 64);
+        s_clientLogHistory = std::allocate_shared<spdlog::sinks::ringbuffer_sink_mt>(allocator, 64);
 
         std::array<spdlog::sink_ptr, 2> engineSinks = {
-            std::make_shared<spdlog::sinks::stdout_color_sink_mt>(),
+            std::allocate_shared<spdlog::sinks::stdout_color_sink_mt>(allocator),
             s_engineLogHistory};
 
         std::array<spdlog::sink_ptr, 2> clientSinks = {
-            std::make_shared<spdlog::sinks::stdout_color_sink_mt>(),
+            std::allocate_shared<spdlog::sinks::stdout_color_sink_mt>(allocator),
             s_clientLogHistory};
 
-        s_engineLogger = std::make_shared<spdlog::logger>(Si::GetLocalized("Engine"), engineSinks.begin(), engineSinks.end());
-        s_clientLogger = std::make_shared<spdlog::logger>(Si::GetLocalized("Client"), clientSinks.begin(), clientSinks.end());
+        s_engineLogger = std::allocate_shared<spdlog::logger>(allocator, Si::GetLocalized("Engine"), engineSinks.begin(), engineSinks.end());
+        s_clientLogger = std::allocate_shared<spdlog::logger>(allocator, Si::GetLocalized("Client"), clientSinks.begin(), clientSinks.end());
 
         if constexpr (SI_BUILD_CONFIG == Si::BuildConfig::Debug)
         {
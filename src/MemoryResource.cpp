@@ -0,0 +1,326 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/22/23.
+//
+
+#include <algorithm>
+#include <new>
+
+#include "boost/assert.hpp"
+
+#include "Silicon/MemoryResource.hpp"
+
+namespace {
+
+constexpr std::size_t AlignUp(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+class NewDeleteResource : public Si::MemoryResource {
+protected:
+    void *allocateImpl(std::size_t bytes, std::size_t alignment) override
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(bytes, std::align_val_t(alignment));
+        }
+
+        return ::operator new(bytes);
+    }
+
+    void deallocateImpl(void *pointer, std::size_t bytes, std::size_t alignment) override
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(pointer, std::align_val_t(alignment));
+            return;
+        }
+
+        ::operator delete(pointer);
+    }
+
+    bool isEqualImpl(const MemoryResource &other) const noexcept override
+    {
+        return dynamic_cast<const NewDeleteResource *>(&other) != nullptr;
+    }
+};
+
+class FrameResource : public Si::MemoryResource {
+protected:
+    void *allocateImpl(std::size_t bytes, std::size_t alignment) override
+    {
+        return Si::GetFrameArena().Allocate(bytes, alignment);
+    }
+
+    void deallocateImpl(void *pointer, std::size_t bytes, std::size_t alignment) override { }
+};
+
+std::atomic<Si::MemoryResource *> s_defaultResource {nullptr};
+
+}
+
+namespace Si {
+
+MemoryResource *GetNewDeleteResource()
+{
+    static NewDeleteResource resource;
+    return &resource;
+}
+
+MemoryResource *GetFrameResource()
+{
+    static FrameResource resource;
+    return &resource;
+}
+
+MemoryResource *GetDefaultResource()
+{
+    MemoryResource *resource = s_defaultResource.load(std::memory_order_acquire);
+    return resource ? resource : GetNewDeleteResource();
+}
+
+MemoryResource *SetDefaultResource(MemoryResource *resource)
+{
+    MemoryResource *previous = s_defaultResource.exchange(resource, std::memory_order_acq_rel);
+    return previous ? previous : GetNewDeleteResource();
+}
+
+struct MonotonicBufferResource::Block {
+    Block *next;
+    std::size_t size;
+
+    static constexpr std::size_t HeaderSize = AlignUp(sizeof(Block *) + sizeof(std::size_t), alignof(std::max_align_t));
+};
+
+MonotonicBufferResource::MonotonicBufferResource(MemoryResource *upstream)
+    : MonotonicBufferResource(nullptr, 0, upstream)
+{
+}
+
+MonotonicBufferResource::MonotonicBufferResource(void *buffer, std::size_t size, MemoryResource *upstream)
+    : m_upstream(upstream)
+    , m_initialBuffer(buffer)
+    , m_initialSize(size)
+    , m_current(static_cast<std::uint8_t *>(buffer))
+    , m_remaining(size)
+    , m_nextBlockSize(std::max<std::size_t>(size * 2, 1024))
+{
+}
+
+MonotonicBufferResource::~MonotonicBufferResource()
+{
+    Release();
+}
+
+void MonotonicBufferResource::Release()
+{
+    while (m_blocks) {
+        Block *next = m_blocks->next;
+        m_upstream->Deallocate(m_blocks, m_blocks->size);
+        m_blocks = next;
+    }
+
+    m_current = static_cast<std::uint8_t *>(m_initialBuffer);
+    m_remaining = m_initialSize;
+    m_nextBlockSize = std::max<std::size_t>(m_initialSize * 2, 1024);
+}
+
+void *MonotonicBufferResource::allocateImpl(std::size_t bytes, std::size_t alignment)
+{
+    BOOST_ASSERT_MSG((alignment & (alignment - 1)) == 0, "Alignment must be a power of two");
+
+    if (m_current) {
+        auto address = reinterpret_cast<std::uintptr_t>(m_current);
+        std::size_t padding = AlignUp(address, alignment) - address;
+
+        if (padding + bytes <= m_remaining) {
+            void *allocation = m_current + padding;
+            m_current += padding + bytes;
+            m_remaining -= padding + bytes;
+            return allocation;
+        }
+    }
+
+    // Blocks start aligned to max_align_t; larger alignments may need padding.
+    std::size_t required = bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+    std::size_t blockSize = std::max(m_nextBlockSize, Block::HeaderSize + required);
+
+    auto *block = static_cast<Block *>(m_upstream->Allocate(blockSize));
+    block->next = m_blocks;
+    block->size = blockSize;
+    m_blocks = block;
+
+    m_nextBlockSize = blockSize * 2;
+
+    auto *data = reinterpret_cast<std::uint8_t *>(block) + Block::HeaderSize;
+    auto address = reinterpret_cast<std::uintptr_t>(data);
+    std::size_t padding = AlignUp(address, alignment) - address;
+
+    m_current = data + padding + bytes;
+    m_remaining = blockSize - Block::HeaderSize - padding - bytes;
+
+    return data + padding;
+}
+
+struct UnsynchronizedPoolResource::FreeBlock {
+    FreeBlock *next;
+};
+
+// Stored at the end of each chunk, after its blocks.
+struct UnsynchronizedPoolResource::Chunk {
+    Chunk *next;
+    void *memory;
+    std::size_t size;
+    std::size_t alignment;
+};
+
+UnsynchronizedPoolResource::UnsynchronizedPoolResource(MemoryResource *upstream)
+    : m_upstream(upstream)
+{
+}
+
+UnsynchronizedPoolResource::~UnsynchronizedPoolResource()
+{
+    Release();
+}
+
+void UnsynchronizedPoolResource::Release()
+{
+    while (m_chunks) {
+        Chunk *next = m_chunks->next;
+        m_upstream->Deallocate(m_chunks->memory, m_chunks->size, m_chunks->alignment);
+        m_chunks = next;
+    }
+
+    std::fill(std::begin(m_freeLists), std::end(m_freeLists), nullptr);
+    std::fill(std::begin(m_chunkBlockCounts), std::end(m_chunkBlockCounts), 0);
+}
+
+std::size_t UnsynchronizedPoolResource::GetPoolIndex(std::size_t bytes, std::size_t alignment)
+{
+    std::size_t size = std::max({bytes, alignment, MinPooledSize});
+    std::size_t index = 0;
+
+    while ((MinPooledSize << index) < size) {
+        index++;
+    }
+
+    return index;
+}
+
+void *UnsynchronizedPoolResource::allocateImpl(std::size_t bytes, std::size_t alignment)
+{
+    if (bytes > MaxPooledSize || alignment > MaxPooledSize) {
+        return m_upstream->Allocate(bytes, alignment);
+    }
+
+    std::size_t index = GetPoolIndex(bytes, alignment);
+
+    if (FreeBlock *block = m_freeLists[index]) {
+        m_freeLists[index] = block->next;
+        return block;
+    }
+
+    // Each chunk holds twice the blocks of the last one, up to 64 KiB.
+    std::size_t blockSize = MinPooledSize << index;
+    std::size_t &blockCount = m_chunkBlockCounts[index];
+    blockCount = blockCount ? std::max(blockCount, std::min(blockCount * 2, 64 * 1024 / blockSize)) : std::max<std::size_t>(1024 / blockSize, 4);
+
+    std::size_t blocksSize = blockCount * blockSize;
+    std::size_t chunkSize = blocksSize + sizeof(Chunk);
+    auto *memory = static_cast<std::uint8_t *>(m_upstream->Allocate(chunkSize, blockSize));
+
+    auto *chunk = reinterpret_cast<Chunk *>(memory + blocksSize);
+    chunk->next = m_chunks;
+    chunk->memory = memory;
+    chunk->size = chunkSize;
+    chunk->alignment = blockSize;
+    m_chunks = chunk;
+
+    // Hand out the first block and thread the rest onto the free list.
+    for (std::size_t i = blockCount; i-- > 1;) {
+        auto *block = reinterpret_cast<FreeBlock *>(memory + i * blockSize);
+        block->next = m_freeLists[index];
+        m_freeLists[index] = block;
+    }
+
+    return memory;
+}
+
+void UnsynchronizedPoolResource::deallocateImpl(void *pointer, std::size_t bytes, std::size_t alignment)
+{
+    if (bytes > MaxPooledSize || alignment > MaxPooledSize) {
+        m_upstream->Deallocate(pointer, bytes, alignment);
+        return;
+    }
+
+    std::size_t index = GetPoolIndex(bytes, alignment);
+    auto *block = static_cast<FreeBlock *>(pointer);
+    block->next = m_freeLists[index];
+    m_freeLists[index] = block;
+}
+
+TrackingResource::TrackingResource(MemoryResource *upstream)
+    : m_upstream(upstream)
+{
+}
+
+TrackingResource::Stats TrackingResource::GetStats() const
+{
+    return {
+        m_liveBytes.load(std::memory_order_relaxed),
+        m_peakBytes.load(std::memory_order_relaxed),
+        m_liveAllocations.load(std::memory_order_relaxed),
+        m_totalAllocations.load(std::memory_order_relaxed),
+    };
+}
+
+void *TrackingResource::allocateImpl(std::size_t bytes, std::size_t alignment)
+{
+    void *pointer = m_upstream->Allocate(bytes, alignment);
+
+    std::size_t live = m_liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    std::size_t peak = m_peakBytes.load(std::memory_order_relaxed);
+
+    while ((live > peak) && !m_peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+
+    m_liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    m_totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    return pointer;
+}
+
+void TrackingResource::deallocateImpl(void *pointer, std::size_t bytes, std::size_t alignment)
+{
+    m_upstream->Deallocate(pointer, bytes, alignment);
+
+    m_liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    m_liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+}
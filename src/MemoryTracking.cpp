@@ -0,0 +1,263 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/23/23.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "Silicon/Log.hpp"
+#include "Silicon/MemoryTracking.hpp"
+
+namespace {
+
+constexpr std::size_t TagCount = static_cast<std::size_t>(Si::MemoryTag::Count);
+
+// How far a thread's byte count may drift before it is folded into the totals.
+constexpr std::int64_t FlushThreshold = 64 * 1024;
+
+struct TagTotals {
+    std::atomic<std::int64_t> liveBytes;
+    std::atomic<std::int64_t> peakBytes;
+    std::atomic<std::int64_t> liveAllocations;
+    std::atomic<std::uint64_t> totalAllocations;
+};
+
+// Deltas a thread has not folded into the totals yet. Only the owning thread writes them, so they are updated with
+// plain loads and stores, and snapshots read them from other threads.
+struct ThreadCounters {
+    std::atomic<std::int64_t> bytes[TagCount];
+    std::atomic<std::int64_t> allocations[TagCount];
+    std::atomic<std::uint64_t> totalAllocations[TagCount];
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadCounters *> threads;
+};
+
+enum class ThreadState : std::uint8_t {
+    Unregistered,
+    Registered,
+    Exited
+};
+
+// Trivially destructible, so allocators used during static destruction can still account to them.
+TagTotals s_totals[TagCount];
+thread_local ThreadCounters t_counters;
+thread_local ThreadState t_state = ThreadState::Unregistered;
+
+Registry &GetRegistry()
+{
+    // Leaked, so threads exiting during static destruction can still unregister.
+    static auto *registry = new Registry;
+    return *registry;
+}
+
+void Add(std::atomic<std::int64_t> &counter, std::int64_t delta)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+void Add(std::atomic<std::uint64_t> &counter, std::uint64_t delta)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+void UpdatePeak(TagTotals &totals, std::int64_t live)
+{
+    std::int64_t peak = totals.peakBytes.load(std::memory_order_relaxed);
+
+    while ((live > peak) && !totals.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+}
+
+void Apply(std::size_t tag, std::int64_t bytes, std::int64_t allocations, std::uint64_t totalAllocations)
+{
+    TagTotals &totals = s_totals[tag];
+
+    std::int64_t live = totals.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    totals.liveAllocations.fetch_add(allocations, std::memory_order_relaxed);
+    totals.totalAllocations.fetch_add(totalAllocations, std::memory_order_relaxed);
+
+    UpdatePeak(totals, live);
+}
+
+void Flush(ThreadCounters &counters, std::size_t tag)
+{
+    Apply(tag,
+        counters.bytes[tag].exchange(0, std::memory_order_relaxed),
+        counters.allocations[tag].exchange(0, std::memory_order_relaxed),
+        counters.totalAllocations[tag].exchange(0, std::memory_order_relaxed));
+}
+
+struct ThreadGuard {
+    ~ThreadGuard()
+    {
+        std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+
+        for (std::size_t tag = 0; tag < TagCount; tag++) {
+            Flush(t_counters, tag);
+        }
+
+        auto &threads = GetRegistry().threads;
+        threads.erase(std::find(threads.begin(), threads.end(), &t_counters));
+
+        t_state = ThreadState::Exited;
+    }
+};
+
+void RegisterThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+        GetRegistry().threads.push_back(&t_counters);
+    }
+
+    thread_local ThreadGuard guard;
+    t_state = ThreadState::Registered;
+}
+
+void Track(Si::MemoryTag tag, std::int64_t bytes, std::int64_t allocations)
+{
+    auto index = static_cast<std::size_t>(tag);
+    std::uint64_t totalAllocations = allocations > 0 ? allocations : 0;
+
+    if (t_state == ThreadState::Unregistered) {
+        RegisterThread();
+    }
+
+    if (t_state == ThreadState::Exited) {
+        Apply(index, bytes, allocations, totalAllocations);
+        return;
+    }
+
+    ThreadCounters &counters = t_counters;
+
+    Add(counters.bytes[index], bytes);
+    Add(counters.allocations[index], allocations);
+    Add(counters.totalAllocations[index], totalAllocations);
+
+    std::int64_t pending = counters.bytes[index].load(std::memory_order_relaxed);
+
+    if ((pending >= FlushThreshold) || (pending <= -FlushThreshold)) {
+        Flush(counters, index);
+    }
+}
+
+}
+
+namespace Si {
+
+MemoryTagStats MemorySnapshot::getTotal() const
+{
+    MemoryTagStats total {};
+
+    for (const MemoryTagStats &stats : tags) {
+        total.liveBytes += stats.liveBytes;
+        total.peakBytes += stats.peakBytes;
+        total.liveAllocations += stats.liveAllocations;
+        total.totalAllocations += stats.totalAllocations;
+    }
+
+    return total;
+}
+
+const char *GetMemoryTagName(MemoryTag tag)
+{
+    switch (tag) {
+    case MemoryTag::General:
+        return "General";
+    case MemoryTag::Nodes:
+        return "Nodes";
+    case MemoryTag::Events:
+        return "Events";
+    case MemoryTag::Assets:
+        return "Assets";
+    case MemoryTag::Renderer:
+        return "Renderer";
+    case MemoryTag::Logging:
+        return "Logging";
+    case MemoryTag::GPU:
+        return "GPU";
+    default:
+        return "Unknown";
+    }
+}
+
+void TrackAllocation(MemoryTag tag, std::size_t bytes)
+{
+    Track(tag, static_cast<std::int64_t>(bytes), 1);
+}
+
+void TrackDeallocation(MemoryTag tag, std::size_t bytes)
+{
+    Track(tag, -static_cast<std::int64_t>(bytes), -1);
+}
+
+MemorySnapshot GetMemorySnapshot()
+{
+    MemorySnapshot snapshot {};
+    std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+
+    for (std::size_t tag = 0; tag < TagCount; tag++) {
+        MemoryTagStats &stats = snapshot.tags[tag];
+
+        stats.liveBytes = s_totals[tag].liveBytes.load(std::memory_order_relaxed);
+        stats.liveAllocations = s_totals[tag].liveAllocations.load(std::memory_order_relaxed);
+        stats.totalAllocations = s_totals[tag].totalAllocations.load(std::memory_order_relaxed);
+
+        for (ThreadCounters *counters : GetRegistry().threads) {
+            stats.liveBytes += counters->bytes[tag].load(std::memory_order_relaxed);
+            stats.liveAllocations += counters->allocations[tag].load(std::memory_order_relaxed);
+            stats.totalAllocations += counters->totalAllocations[tag].load(std::memory_order_relaxed);
+        }
+
+        // Unflushed growth may have raised the peak without the totals seeing it yet.
+        UpdatePeak(s_totals[tag], stats.liveBytes);
+        stats.peakBytes = s_totals[tag].peakBytes.load(std::memory_order_relaxed);
+    }
+
+    return snapshot;
+}
+
+void LogMemorySnapshot()
+{
+    MemorySnapshot snapshot = GetMemorySnapshot();
+
+    for (std::size_t tag = 0; tag < TagCount; tag++) {
+        const MemoryTagStats &stats = snapshot.tags[tag];
+
+        Engine::Info("{:>9}: {:>12} bytes live, {:>12} bytes peak, {:>8} live allocations, {:>10} total",
+            GetMemoryTagName(static_cast<MemoryTag>(tag)), stats.liveBytes, stats.peakBytes, stats.liveAllocations, stats.totalAllocations);
+    }
+}
+
+}
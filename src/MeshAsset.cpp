@@ -0,0 +1,548 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/19/23.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "tiny_gltf.h"
+
+#include "Silicon/Async.hpp"
+#include "Silicon/Log.hpp"
+#include "Silicon/MeshAsset.hpp"
+
+namespace {
+
+static_assert(sizeof(Si::MeshAsset::CookedHeader) == 80);
+static_assert(sizeof(Si::MeshAsset::CookedMesh) == 16);
+static_assert(sizeof(Si::MeshAsset::Primitive) == 16);
+
+// Large primitives are split so a single mesh still spreads across workers.
+constexpr std::size_t VertexChunkSize = 16384;
+
+/*
+ * Where an accessor's elements live in its buffer, and how to read them.
+ */
+struct AccessorView {
+    const std::uint8_t *data = nullptr;
+    std::size_t stride = 0;
+    std::size_t count = 0;
+    int componentType = 0;
+    int componentCount = 0;
+    bool normalized = false;
+};
+
+AccessorView GetAccessorView(const tinygltf::Model &model, int index, const std::string &path)
+{
+    auto fail = [&path](const std::string &reason) {
+        Si::Engine::Error("Invalid mesh {}: {}", path, reason);
+        throw std::runtime_error("Invalid mesh " + path + ": " + reason);
+    };
+
+    if (index < 0 || static_cast<std::size_t>(index) >= model.accessors.size()) {
+        fail("accessor out of range");
+    }
+
+    const tinygltf::Accessor &accessor = model.accessors[index];
+
+    if (accessor.sparse.isSparse) {
+        fail("sparse accessors are not supported");
+    }
+
+    if (accessor.bufferView < 0 || static_cast<std::size_t>(accessor.bufferView) >= model.bufferViews.size()) {
+        fail("accessor without a buffer view");
+    }
+
+    const tinygltf::BufferView &bufferView = model.bufferViews[accessor.bufferView];
+
+    if (bufferView.buffer < 0 || static_cast<std::size_t>(bufferView.buffer) >= model.buffers.size()) {
+        fail("buffer view out of range");
+    }
+
+    const tinygltf::Buffer &buffer = model.buffers[bufferView.buffer];
+
+    AccessorView view;
+    view.count = accessor.count;
+    view.componentType = accessor.componentType;
+    view.componentCount = tinygltf::GetNumComponentsInType(static_cast<std::uint32_t>(accessor.type));
+    view.normalized = accessor.normalized;
+
+    int componentSize = tinygltf::GetComponentSizeInBytes(static_cast<std::uint32_t>(accessor.componentType));
+    int stride = accessor.ByteStride(bufferView);
+
+    if (view.componentCount <= 0 || componentSize <= 0 || stride <= 0) {
+        fail("unsupported accessor type");
+    }
+
+    view.stride = static_cast<std::size_t>(stride);
+
+    std::size_t offset = bufferView.byteOffset + accessor.byteOffset;
+    std::size_t elementSize = static_cast<std::size_t>(view.componentCount * componentSize);
+
+    if (view.count && (bufferView.byteOffset + bufferView.byteLength > buffer.data.size() ||
+                       accessor.byteOffset + (view.count - 1) * view.stride + elementSize > bufferView.byteLength)) {
+        fail("accessor overruns its buffer");
+    }
+
+    view.data = buffer.data.data() + offset;
+    return view;
+}
+
+float ReadComponent(const std::uint8_t *data, int componentType, bool normalized)
+{
+    switch (componentType) {
+    case TINYGLTF_COMPONENT_TYPE_FLOAT: {
+        float value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+        return normalized ? *data / 255.0f : *data;
+    case TINYGLTF_COMPONENT_TYPE_BYTE: {
+        auto value = static_cast<std::int8_t>(*data);
+        return normalized ? std::max(value / 127.0f, -1.0f) : value;
+    }
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+        std::uint16_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return normalized ? value / 65535.0f : value;
+    }
+    case TINYGLTF_COMPONENT_TYPE_SHORT: {
+        std::int16_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+    }
+    default:
+        return 0.0f;
+    }
+}
+
+std::uint32_t ReadIndex(const std::uint8_t *data, int componentType)
+{
+    switch (componentType) {
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+        return *data;
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: {
+        std::uint16_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+    default: {
+        std::uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+    }
+}
+
+struct PrimitiveJob {
+    Si::MeshAsset::Primitive range;
+    AccessorView positions;
+    AccessorView colors;
+    AccessorView indices;
+    bool hasColors = false;
+    bool hasIndices = false;
+};
+
+bool IsSupportedFloat(const AccessorView &view)
+{
+    return view.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT || view.normalized;
+}
+
+[[noreturn]] void Fail(const std::string &path, const std::string &reason)
+{
+    Si::Engine::Error("Failed to load mesh {}: {}", path, reason);
+    throw std::runtime_error("Failed to load mesh " + path + ": " + reason);
+}
+
+std::uint32_t ReadMagic(const std::uint8_t *data)
+{
+    std::uint32_t magic;
+    std::memcpy(&magic, data, sizeof(magic));
+    return magic;
+}
+
+}
+
+namespace Si {
+
+MeshAsset::MeshAsset(std::string path)
+    : Asset(std::move(path))
+{
+    Span<const std::uint8_t> bytes = GetBytes();
+
+    if (bytes.size() >= sizeof(std::uint32_t) && ReadMagic(bytes.data()) == CookedMagic) {
+        loadCooked();
+    } else {
+        loadGltf();
+    }
+
+    Engine::Trace("Loaded mesh {}: {} vertices, {} indices", GetPath(), m_vertexCount, m_indexCount);
+}
+
+void MeshAsset::loadGltf()
+{
+    auto fail = [this](const std::string &reason) { Fail(GetPath(), reason); };
+
+    tinygltf::TinyGLTF loader;
+    tinygltf::Model model;
+    std::string error, warning;
+
+    // Meshes never need their textures decoded, those are loaded as their own assets.
+    loader.SetImageLoader(
+        [](tinygltf::Image *, const int, std::string *, std::string *, int, int, const unsigned char *, int, void *) { return true; },
+        nullptr);
+
+    std::size_t separator = GetPath().find_last_of("/\\");
+    std::string baseDirectory = separator == std::string::npos ? "." : GetPath().substr(0, separator);
+
+    Span<const std::uint8_t> bytes = GetBytes();
+    bool isBinary = bytes.size() >= 4 && std::memcmp(bytes.data(), "glTF", 4) == 0;
+
+    bool loaded = isBinary
+        ? loader.LoadBinaryFromMemory(&model, &error, &warning, bytes.data(), static_cast<unsigned int>(bytes.size()), baseDirectory)
+        : loader.LoadASCIIFromString(&model, &error, &warning, reinterpret_cast<const char *>(bytes.data()),
+            static_cast<unsigned int>(bytes.size()), baseDirectory);
+
+    if (!warning.empty()) {
+        Engine::Warn("While loading mesh {}: {}", GetPath(), warning);
+    }
+
+    if (!loaded) {
+        fail(error);
+    }
+
+    // Lay out every primitive first, so they can all decode in parallel into their own part of the staging buffer.
+    // Most models have a handful of primitives, so their jobs fit on the stack.
+    InlineBufferResource<2048> scratch;
+    pmr::Vector<PrimitiveJob> jobs(&scratch);
+    std::size_t vertexCount = 0;
+    std::size_t indexCount = 0;
+
+    for (const tinygltf::Mesh &gltfMesh : model.meshes) {
+        Mesh &mesh = m_meshes.emplace_back();
+        mesh.name = gltfMesh.name;
+
+        for (const tinygltf::Primitive &primitive : gltfMesh.primitives) {
+            if (primitive.mode != TINYGLTF_MODE_TRIANGLES && primitive.mode != -1) {
+                Engine::Warn("Skipping a primitive of mesh {} in {}, only triangles are supported", gltfMesh.name, GetPath());
+                continue;
+            }
+
+            auto position = primitive.attributes.find("POSITION");
+            if (position == primitive.attributes.end()) {
+                Engine::Warn("Skipping a primitive of mesh {} in {} without positions", gltfMesh.name, GetPath());
+                continue;
+            }
+
+            PrimitiveJob job;
+            job.positions = GetAccessorView(model, position->second, GetPath());
+
+            if (job.positions.componentCount < 2 || !IsSupportedFloat(job.positions)) {
+                fail("unsupported position format");
+            }
+
+            if (auto color = primitive.attributes.find("COLOR_0"); color != primitive.attributes.end()) {
+                job.colors = GetAccessorView(model, color->second, GetPath());
+                job.hasColors = true;
+
+                if (job.colors.count != job.positions.count || job.colors.componentCount < 3 || !IsSupportedFloat(job.colors)) {
+                    fail("unsupported color format");
+                }
+            }
+
+            if (primitive.indices >= 0) {
+                job.indices = GetAccessorView(model, primitive.indices, GetPath());
+                job.hasIndices = true;
+
+                if (job.indices.componentCount != 1 || (job.indices.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE &&
+                                                          job.indices.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT &&
+                                                          job.indices.componentType != TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT)) {
+                    fail("unsupported index format");
+                }
+            }
+
+            std::size_t primitiveIndexCount = job.hasIndices ? job.indices.count : job.positions.count;
+
+            if (vertexCount + job.positions.count > std::numeric_limits<std::uint32_t>::max() ||
+                indexCount + primitiveIndexCount > std::numeric_limits<std::uint32_t>::max()) {
+                fail("too many vertices");
+            }
+
+            job.range = {static_cast<std::uint32_t>(vertexCount), static_cast<std::uint32_t>(job.positions.count),
+                static_cast<std::uint32_t>(indexCount), static_cast<std::uint32_t>(primitiveIndexCount)};
+
+            vertexCount += job.positions.count;
+            indexCount += primitiveIndexCount;
+
+            mesh.primitives.push_back(job.range);
+            jobs.push_back(job);
+        }
+    }
+
+    m_vertexCount = vertexCount;
+    m_indexCount = indexCount;
+    m_decoded.resize(GetIndexOffset() + indexCount * sizeof(Index));
+    m_staging = Span<const std::uint8_t>(m_decoded.data(), m_decoded.size());
+
+    auto *vertices = reinterpret_cast<Vertex *>(m_decoded.data());
+    auto *indices = reinterpret_cast<Index *>(m_decoded.data() + GetIndexOffset());
+    std::atomic<bool> indicesValid = true;
+
+    Vector<std::function<void()>> tasks;
+
+    for (const PrimitiveJob &job : jobs) {
+        for (std::size_t begin = 0; begin < job.range.vertexCount; begin += VertexChunkSize) {
+            std::size_t end = std::min<std::size_t>(begin + VertexChunkSize, job.range.vertexCount);
+
+            tasks.emplace_back([&job, begin, end, vertices]() {
+                int positionSize = tinygltf::GetComponentSizeInBytes(static_cast<std::uint32_t>(job.positions.componentType));
+                int colorSize = job.hasColors ? tinygltf::GetComponentSizeInBytes(static_cast<std::uint32_t>(job.colors.componentType)) : 0;
+
+                for (std::size_t i = begin; i < end; i++) {
+                    Vertex &vertex = vertices[job.range.vertexOffset + i];
+                    const std::uint8_t *position = job.positions.data + i * job.positions.stride;
+
+                    // Vertices are 2D for now, so Z is dropped.
+                    vertex.position = {ReadComponent(position, job.positions.componentType, job.positions.normalized),
+                        ReadComponent(position + positionSize, job.positions.componentType, job.positions.normalized)};
+
+                    if (!job.hasColors) {
+                        vertex.color = {1.0f, 1.0f, 1.0f};
+                        continue;
+                    }
+
+                    const std::uint8_t *color = job.colors.data + i * job.colors.stride;
+                    vertex.color = {ReadComponent(color, job.colors.componentType, job.colors.normalized),
+                        ReadComponent(color + colorSize, job.colors.componentType, job.colors.normalized),
+                        ReadComponent(color + 2 * colorSize, job.colors.componentType, job.colors.normalized)};
+                }
+            });
+        }
+
+        tasks.emplace_back([&job, indices, &indicesValid]() {
+            Index *out = indices + job.range.firstIndex;
+
+            if (!job.hasIndices) {
+                for (std::uint32_t i = 0; i < job.range.indexCount; i++) {
+                    out[i] = i;
+                }
+
+                return;
+            }
+
+            for (std::uint32_t i = 0; i < job.range.indexCount; i++) {
+                out[i] = ReadIndex(job.indices.data + i * job.indices.stride, job.indices.componentType);
+
+                if (out[i] >= job.range.vertexCount) {
+                    indicesValid = false;
+                    return;
+                }
+            }
+        });
+    }
+
+    // Running a taskflow from one of the executor's own workers and waiting on it could leave every worker waiting, which happens when
+    // a mesh is loaded from an async task.
+    if (GetAsyncExecutor().this_worker_id() >= 0) {
+        for (std::function<void()> &task : tasks) {
+            task();
+        }
+    } else {
+        tf::Taskflow taskflow;
+
+        for (std::function<void()> &task : tasks) {
+            taskflow.emplace(std::move(task));
+        }
+
+        GetAsyncExecutor().run(taskflow).wait();
+    }
+
+    if (!indicesValid) {
+        fail("index out of range");
+    }
+}
+
+void MeshAsset::loadCooked()
+{
+    auto fail = [this](const std::string &reason) { Fail(GetPath(), reason); };
+
+    Span<const std::uint8_t> bytes = GetBytes();
+
+    CookedHeader header {};
+    if (bytes.size() < sizeof(header)) {
+        fail("truncated header");
+    }
+
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if (header.version != CookedVersion || header.vertexSize != sizeof(Vertex)) {
+        fail("cooked with a different version or vertex layout, cook it again");
+    }
+
+    auto inBounds = [&bytes](std::uint64_t offset, std::uint64_t size) {
+        return offset <= bytes.size() && size <= bytes.size() - offset;
+    };
+
+    if (!inBounds(header.meshesOffset, std::uint64_t(header.meshCount) * sizeof(CookedMesh)) ||
+        !inBounds(header.primitivesOffset, std::uint64_t(header.primitiveCount) * sizeof(Primitive)) ||
+        !inBounds(header.stagingOffset, header.stagingSize) || header.namesOffset > bytes.size() ||
+        header.stagingOffset % alignof(Vertex) || header.vertexCount > std::numeric_limits<std::uint32_t>::max() ||
+        header.indexCount > std::numeric_limits<std::uint32_t>::max()) {
+        fail("corrupt header");
+    }
+
+    m_vertexCount = header.vertexCount;
+    m_indexCount = header.indexCount;
+
+    if (GetIndexOffset() + m_indexCount * sizeof(Index) != header.stagingSize) {
+        fail("corrupt staging buffer");
+    }
+
+    // The file holds the staging buffer as it is uploaded, so it is used in place.
+    m_staging = bytes.subspan(header.stagingOffset, header.stagingSize);
+
+    Vector<Primitive> primitives(header.primitiveCount);
+    std::memcpy(primitives.data(), bytes.data() + header.primitivesOffset, primitives.size() * sizeof(Primitive));
+
+    std::string_view names(reinterpret_cast<const char *>(bytes.data() + header.namesOffset), bytes.size() - header.namesOffset);
+
+    for (std::uint32_t i = 0; i < header.meshCount; i++) {
+        CookedMesh cooked {};
+        std::memcpy(&cooked, bytes.data() + header.meshesOffset + i * sizeof(CookedMesh), sizeof(cooked));
+
+        if (cooked.nameOffset > names.size() || cooked.nameLength > names.size() - cooked.nameOffset ||
+            cooked.firstPrimitive > primitives.size() || cooked.primitiveCount > primitives.size() - cooked.firstPrimitive) {
+            fail("corrupt mesh table");
+        }
+
+        Mesh &mesh = m_meshes.emplace_back();
+        mesh.name = names.substr(cooked.nameOffset, cooked.nameLength);
+        mesh.primitives.assign(primitives.begin() + cooked.firstPrimitive, primitives.begin() + cooked.firstPrimitive + cooked.primitiveCount);
+
+        for (const Primitive &primitive : mesh.primitives) {
+            if (std::uint64_t(primitive.vertexOffset) + primitive.vertexCount > m_vertexCount ||
+                std::uint64_t(primitive.firstIndex) + primitive.indexCount > m_indexCount) {
+                fail("corrupt primitive");
+            }
+        }
+    }
+}
+
+bool MeshAsset::Cook(const std::string &path) const
+{
+    CookedHeader header {};
+    header.magic = CookedMagic;
+    header.version = CookedVersion;
+    header.vertexSize = sizeof(Vertex);
+    header.meshCount = static_cast<std::uint32_t>(m_meshes.size());
+    header.vertexCount = m_vertexCount;
+    header.indexCount = m_indexCount;
+
+    Vector<CookedMesh> meshes;
+    Vector<Primitive> primitives;
+    std::string names;
+
+    for (const Mesh &mesh : m_meshes) {
+        meshes.push_back({static_cast<std::uint32_t>(names.size()), static_cast<std::uint32_t>(mesh.name.size()),
+            static_cast<std::uint32_t>(primitives.size()), static_cast<std::uint32_t>(mesh.primitives.size())});
+
+        names += mesh.name;
+        primitives.insert(primitives.end(), mesh.primitives.begin(), mesh.primitives.end());
+    }
+
+    header.primitiveCount = static_cast<std::uint32_t>(primitives.size());
+    header.meshesOffset = sizeof(CookedHeader);
+    header.primitivesOffset = header.meshesOffset + meshes.size() * sizeof(CookedMesh);
+    header.namesOffset = header.primitivesOffset + primitives.size() * sizeof(Primitive);
+    header.stagingOffset = (header.namesOffset + names.size() + CookedAlignment - 1) / CookedAlignment * CookedAlignment;
+    header.stagingSize = m_staging.size();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        Engine::Error("Failed to open cooked mesh for writing: {}", path);
+        return false;
+    }
+
+    static const char padding[CookedAlignment] {};
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(meshes.data()), static_cast<std::streamsize>(meshes.size() * sizeof(CookedMesh)));
+    file.write(reinterpret_cast<const char *>(primitives.data()), static_cast<std::streamsize>(primitives.size() * sizeof(Primitive)));
+    file.write(names.data(), static_cast<std::streamsize>(names.size()));
+    file.write(padding, static_cast<std::streamsize>(header.stagingOffset - header.namesOffset - names.size()));
+    file.write(reinterpret_cast<const char *>(m_staging.data()), static_cast<std::streamsize>(m_staging.size()));
+
+    if (!file) {
+        Engine::Error("Failed to write cooked mesh: {}", path);
+        return false;
+    }
+
+    return true;
+}
+
+Span<const MeshAsset::Mesh> MeshAsset::GetMeshes() const
+{
+    return {m_meshes.data(), m_meshes.size()};
+}
+
+Span<const Vertex> MeshAsset::GetVertices() const
+{
+    return {reinterpret_cast<const Vertex *>(m_staging.data()), m_vertexCount};
+}
+
+Span<const MeshAsset::Index> MeshAsset::GetIndices() const
+{
+    return {reinterpret_cast<const Index *>(m_staging.data() + GetIndexOffset()), m_indexCount};
+}
+
+Span<const std::uint8_t> MeshAsset::GetStagingBuffer() const
+{
+    return m_staging;
+}
+
+std::size_t MeshAsset::GetIndexOffset() const
+{
+    std::size_t vertexBytes = m_vertexCount * sizeof(Vertex);
+    return (vertexBytes + alignof(Index) - 1) / alignof(Index) * alignof(Index);
+}
+
+std::size_t MeshAsset::GetResidentSize() const
+{
+    return Asset::GetResidentSize() + m_decoded.size();
+}
+
+}
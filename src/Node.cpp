@@ -34,11 +34,11 @@ namespace Si
 {
 
 unsigned Node::s_currentID = 0;
-NodeGraph Node::s_graph;
+NodeHierarchy Node::s_hierarchy;
 
 Node::Node()
     : m_id(s_currentID++)
-    , m_graphDescriptor(boost::add_vertex(NotNull<Node *>(this), s_graph))
+    , m_handle(s_hierarchy.insert(NotNull<Node *>(this)))
 {
 }
 
@@ -50,7 +50,7 @@ Node::Node(std::initializer_list<Node *> children)
 
 void Node::addChild(NotNull<Node *> node)
 {
-    boost::add_edge(m_graphDescriptor, node->m_graphDescriptor, s_graph);
+    s_hierarchy.attach(m_handle, node->m_handle);
 }
 
 void Node::addChild(Node &node)
@@ -60,19 +60,27 @@ void Node::addChild(Node &node)
 
 Node::~Node()
 {
-    boost::clear_vertex(m_graphDescriptor, s_graph);
-    boost::remove_vertex(m_graphDescriptor, s_graph);
+    s_hierarchy.erase(m_handle);
+}
+
+Node *Node::getParent() const
+{
+    NodeHandle parent = s_hierarchy.getParent(m_handle);
+    return s_hierarchy.isValid(parent) ? s_hierarchy.getNode(parent) : nullptr;
+}
+
+NodeHandle Node::getHandle() const
+{
+    return m_handle;
 }
 
 Node::ChildIterator Node::begin() const
 {
-    auto [begin, end] = boost::adjacent_vertices(m_graphDescriptor, s_graph);
-    return Node::ChildIterator { begin };
+    return Node::ChildIterator { m_handle, s_hierarchy.getFirstChild(m_handle) };
 }
 Node::ChildIterator Node::end() const
 {
-    auto [begin, end] = boost::adjacent_vertices(m_graphDescriptor, s_graph);
-    return Node::ChildIterator {end};
+    return Node::ChildIterator { m_handle, {} };
 }
 Node &Node::addChildren(std::initializer_list<Node *> children)
 {
@@ -83,26 +91,26 @@ Node &Node::addChildren(std::initializer_list<Node *> children)
     return *this;
 }
 
-Node::ChildIterator::ChildIterator(NodeGraph::adjacency_iterator itr)
-: m_itr(itr) { }
+Node::ChildIterator::ChildIterator(NodeHandle parent, NodeHandle child)
+: m_parent(parent), m_child(child) { }
 
 Node& Node::ChildIterator::operator*()
 {
-    return *s_graph[static_cast<NodeGraph::vertex_descriptor>(*m_itr)];
+    return *s_hierarchy.getNode(m_child);
 }
 
 Node* Node::ChildIterator::operator->()
 {
-    return s_graph[static_cast<NodeGraph::vertex_descriptor>(*m_itr)];
+    return s_hierarchy.getNode(m_child);
 }
 Node::ChildIterator& Node::ChildIterator::operator++()
 {
-    ++m_itr;
+    m_child = s_hierarchy.getNextSibling(m_child);
     return *this;
 }
 Node::ChildIterator& Node::ChildIterator::operator--()
 {
-    --m_itr;
+    m_child = s_hierarchy.isValid(m_child) ? s_hierarchy.getPrevSibling(m_child) : s_hierarchy.getLastChild(m_parent);
     return *this;
 }
 const Node::ChildIterator Node::ChildIterator::operator++(int)
@@ -119,7 +127,7 @@ const Node::ChildIterator Node::ChildIterator::operator--(int)
 }
 bool Node::ChildIterator::operator==(const ChildIterator& other)
 {
-    return m_itr == other.m_itr;
+    return m_child == other.m_child;
 }
 bool Node::ChildIterator::operator!=(const ChildIterator& other)
 {
@@ -127,4 +135,3 @@ bool Node::ChildIterator::operator!=(const ChildIterator& other)
 }
 
 }
-
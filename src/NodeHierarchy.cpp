@@ -0,0 +1,396 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/9/23.
+//
+
+#include <algorithm>
+
+#include "boost/assert.hpp"
+
+#include "Silicon/NodeHierarchy.hpp"
+
+namespace Si {
+
+NodeHandle NodeHierarchy::insert(NotNull<Node *> node)
+{
+    Index slotIndex;
+
+    if (m_freeSlots.empty()) {
+        slotIndex = static_cast<Index>(m_slots.size());
+        m_slots.emplace_back();
+    } else {
+        slotIndex = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+
+    auto position = static_cast<Index>(m_nodes.size());
+    m_slots[slotIndex].position = position;
+
+    // A new root appended to the end keeps the depth-first order intact.
+    m_nodes.push_back(node);
+    m_parents.push_back(NullIndex);
+    m_firstChildren.push_back(NullIndex);
+    m_lastChildren.push_back(NullIndex);
+    m_nextSiblings.push_back(NullIndex);
+    m_prevSiblings.push_back(NullIndex);
+    m_subtreeSizes.push_back(1);
+    m_slotIndices.push_back(slotIndex);
+
+    return {slotIndex, m_slots[slotIndex].generation};
+}
+
+void NodeHierarchy::erase(NodeHandle handle)
+{
+    Index position = getCheckedPosition(handle);
+
+    for (Index child = m_firstChildren[position]; child != NullIndex;) {
+        Index next = m_nextSiblings[child];
+
+        m_parents[child] = NullIndex;
+        m_nextSiblings[child] = NullIndex;
+        m_prevSiblings[child] = NullIndex;
+
+        child = next;
+    }
+
+    m_firstChildren[position] = NullIndex;
+    m_lastChildren[position] = NullIndex;
+
+    unlink(position);
+
+    auto last = static_cast<Index>(m_nodes.size() - 1);
+
+    if (position != last) {
+        move(last, position);
+    }
+
+    m_nodes.pop_back();
+    m_parents.pop_back();
+    m_firstChildren.pop_back();
+    m_lastChildren.pop_back();
+    m_nextSiblings.pop_back();
+    m_prevSiblings.pop_back();
+    m_subtreeSizes.pop_back();
+    m_slotIndices.pop_back();
+
+    Slot &slot = m_slots[handle.index];
+    slot.position = NullIndex;
+    slot.generation++;
+    m_freeSlots.push_back(handle.index);
+
+    m_sorted = false;
+}
+
+void NodeHierarchy::attach(NodeHandle parent, NodeHandle child)
+{
+    Index parentPosition = getCheckedPosition(parent);
+    Index childPosition = getCheckedPosition(child);
+
+    BOOST_ASSERT_MSG(!isAncestor(childPosition, parentPosition), "Attaching a node to its own descendant would create a cycle!");
+
+    unlink(childPosition);
+
+    Index lastChild = m_lastChildren[parentPosition];
+
+    m_parents[childPosition] = parentPosition;
+    m_prevSiblings[childPosition] = lastChild;
+
+    if (lastChild != NullIndex) {
+        m_nextSiblings[lastChild] = childPosition;
+    } else {
+        m_firstChildren[parentPosition] = childPosition;
+    }
+
+    m_lastChildren[parentPosition] = childPosition;
+
+    m_sorted = false;
+}
+
+void NodeHierarchy::detach(NodeHandle child)
+{
+    Index position = getCheckedPosition(child);
+
+    if (m_parents[position] != NullIndex) {
+        unlink(position);
+        m_sorted = false;
+    }
+}
+
+bool NodeHierarchy::isValid(NodeHandle handle) const
+{
+    return (handle.index < m_slots.size())
+        && (m_slots[handle.index].generation == handle.generation)
+        && (m_slots[handle.index].position != NullIndex);
+}
+
+Node *NodeHierarchy::getNode(NodeHandle handle) const
+{
+    return m_nodes[getCheckedPosition(handle)];
+}
+
+NodeHandle NodeHierarchy::getParent(NodeHandle handle) const
+{
+    return getHandleAt(m_parents[getCheckedPosition(handle)]);
+}
+
+NodeHandle NodeHierarchy::getFirstChild(NodeHandle handle) const
+{
+    return getHandleAt(m_firstChildren[getCheckedPosition(handle)]);
+}
+
+NodeHandle NodeHierarchy::getLastChild(NodeHandle handle) const
+{
+    return getHandleAt(m_lastChildren[getCheckedPosition(handle)]);
+}
+
+NodeHandle NodeHierarchy::getNextSibling(NodeHandle handle) const
+{
+    return getHandleAt(m_nextSiblings[getCheckedPosition(handle)]);
+}
+
+NodeHandle NodeHierarchy::getPrevSibling(NodeHandle handle) const
+{
+    return getHandleAt(m_prevSiblings[getCheckedPosition(handle)]);
+}
+
+std::size_t NodeHierarchy::size() const
+{
+    return m_nodes.size();
+}
+
+void NodeHierarchy::sort()
+{
+    if (m_sorted) {
+        return;
+    }
+
+    auto count = static_cast<Index>(m_nodes.size());
+
+    // Scratch space for the traversal, small hierarchies sort without touching the heap.
+    InlineBufferResource<4096> scratch;
+
+    pmr::Vector<Index> order(&scratch);
+    order.reserve(count);
+
+    for (Index root = 0; root < count; root++) {
+        if (m_parents[root] != NullIndex) {
+            continue;
+        }
+
+        Index current = root;
+
+        while (true) {
+            order.push_back(current);
+
+            if (m_firstChildren[current] != NullIndex) {
+                current = m_firstChildren[current];
+                continue;
+            }
+
+            while ((current != root) && (m_nextSiblings[current] == NullIndex)) {
+                current = m_parents[current];
+            }
+
+            if (current == root) {
+                break;
+            }
+
+            current = m_nextSiblings[current];
+        }
+    }
+
+    BOOST_ASSERT_MSG(order.size() == count, "Node hierarchy contains a cycle!");
+
+    pmr::Vector<Index> newPositions(count, &scratch);
+
+    for (Index i = 0; i < count; i++) {
+        newPositions[order[i]] = i;
+    }
+
+    auto remapLinks = [&order, &newPositions, count](NodeVector<Index> &links) {
+        NodeVector<Index> sorted(count);
+
+        for (Index i = 0; i < count; i++) {
+            Index link = links[order[i]];
+            sorted[i] = (link == NullIndex) ? NullIndex : newPositions[link];
+        }
+
+        links.swap(sorted);
+    };
+
+    remapLinks(m_parents);
+    remapLinks(m_firstChildren);
+    remapLinks(m_lastChildren);
+    remapLinks(m_nextSiblings);
+    remapLinks(m_prevSiblings);
+
+    NodeVector<Node *> sortedNodes(count);
+    NodeVector<Index> sortedSlotIndices(count);
+
+    for (Index i = 0; i < count; i++) {
+        sortedNodes[i] = m_nodes[order[i]];
+        sortedSlotIndices[i] = m_slotIndices[order[i]];
+        m_slots[sortedSlotIndices[i]].position = i;
+    }
+
+    m_nodes.swap(sortedNodes);
+    m_slotIndices.swap(sortedSlotIndices);
+
+    // Parents always precede their children, so a single reverse pass accumulates every subtree size.
+    std::fill(m_subtreeSizes.begin(), m_subtreeSizes.end(), 1);
+
+    for (Index i = count; i-- > 0;) {
+        if (m_parents[i] != NullIndex) {
+            m_subtreeSizes[m_parents[i]] += m_subtreeSizes[i];
+        }
+    }
+
+    m_sorted = true;
+}
+
+NodeHierarchy::Index NodeHierarchy::getPosition(NodeHandle handle)
+{
+    sort();
+    return getCheckedPosition(handle);
+}
+
+NodeHierarchy::Index NodeHierarchy::getSubtreeSize(Index position)
+{
+    sort();
+    return m_subtreeSizes[position];
+}
+
+NodeHierarchy::Index NodeHierarchy::getParentPosition(Index position)
+{
+    sort();
+    return m_parents[position];
+}
+
+Node &NodeHierarchy::getNodeAt(Index position)
+{
+    sort();
+    return *m_nodes[position];
+}
+
+NodeHierarchy::Index NodeHierarchy::getCheckedPosition(NodeHandle handle) const
+{
+    BOOST_ASSERT_MSG(isValid(handle), "Invalid node handle!");
+    return m_slots[handle.index].position;
+}
+
+NodeHandle NodeHierarchy::getHandleAt(Index position) const
+{
+    if (position == NullIndex) {
+        return {};
+    }
+
+    Index slotIndex = m_slotIndices[position];
+    return {slotIndex, m_slots[slotIndex].generation};
+}
+
+bool NodeHierarchy::isAncestor(Index ancestor, Index position) const
+{
+    for (Index current = position; current != NullIndex; current = m_parents[current]) {
+        if (current == ancestor) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void NodeHierarchy::unlink(Index position)
+{
+    Index parent = m_parents[position];
+
+    if (parent == NullIndex) {
+        return;
+    }
+
+    Index prev = m_prevSiblings[position];
+    Index next = m_nextSiblings[position];
+
+    if (prev != NullIndex) {
+        m_nextSiblings[prev] = next;
+    } else {
+        m_firstChildren[parent] = next;
+    }
+
+    if (next != NullIndex) {
+        m_prevSiblings[next] = prev;
+    } else {
+        m_lastChildren[parent] = prev;
+    }
+
+    m_parents[position] = NullIndex;
+    m_prevSiblings[position] = NullIndex;
+    m_nextSiblings[position] = NullIndex;
+}
+
+void NodeHierarchy::move(Index from, Index to)
+{
+    Index parent = m_parents[from];
+    Index prev = m_prevSiblings[from];
+    Index next = m_nextSiblings[from];
+
+    if (parent != NullIndex) {
+        if (m_firstChildren[parent] == from) {
+            m_firstChildren[parent] = to;
+        }
+
+        if (m_lastChildren[parent] == from) {
+            m_lastChildren[parent] = to;
+        }
+    }
+
+    if (prev != NullIndex) {
+        m_nextSiblings[prev] = to;
+    }
+
+    if (next != NullIndex) {
+        m_prevSiblings[next] = to;
+    }
+
+    for (Index child = m_firstChildren[from]; child != NullIndex; child = m_nextSiblings[child]) {
+        m_parents[child] = to;
+    }
+
+    m_nodes[to] = m_nodes[from];
+    m_parents[to] = parent;
+    m_firstChildren[to] = m_firstChildren[from];
+    m_lastChildren[to] = m_lastChildren[from];
+    m_nextSiblings[to] = next;
+    m_prevSiblings[to] = prev;
+    m_subtreeSizes[to] = m_subtreeSizes[from];
+    m_slotIndices[to] = m_slotIndices[from];
+
+    m_slots[m_slotIndices[to]].position = to;
+}
+
+}
@@ -33,7 +33,7 @@
 namespace {
 
 // A map of all registered renderers.
-Si::HashMap<std::string, std::unique_ptr<Si::Renderer>> registered_renderers;
+Si::Tagged<Si::MemoryTag::Renderer>::HashMap<std::string, std::unique_ptr<Si::Renderer>> registered_renderers;
 
 }
 
@@ -44,4 +44,10 @@ void Renderer::RegisterRenderer(const std::string &name, std::unique_ptr<Rendere
     registered_renderers[name] = std::move(renderer);
 }
 
+Renderer *Renderer::GetRenderer(const std::string &name)
+{
+    auto i = registered_renderers.find(name);
+    return i != registered_renderers.end() ? i->second.get() : nullptr;
+}
+
 }
\ No newline at end of file
@@ -28,6 +28,8 @@
 
 #include "boost/assert.hpp"
 
+#include "Silicon/Allocator.hpp"
+#include "Silicon/Asset.hpp"
 #include "Silicon/Localization.hpp"
 #include "Silicon/Log.hpp"
 #include "Silicon/Silicon.hpp"
@@ -59,6 +61,8 @@ bool Initialize()
 void Deinitialize()
 {
     Engine::Debug(Si::GetLocalized("Shutting down Silicon Engine..."));
+
+    Asset::Shutdown();
 }
 
 void SetLoop(std::function<bool()> loop)
@@ -70,6 +74,10 @@ bool Loop()
 {
     BOOST_ASSERT_MSG(s_loop, Si::GetLocalized("Loop function not defined! Make sure you set one with Si::SetLoop()").c_str());
 
-    return s_loop();
+    bool running = s_loop();
+
+    ResetFrameArenas();
+
+    return running;
 }
 } // namespace Engine
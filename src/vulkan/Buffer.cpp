@@ -2,58 +2,47 @@
 // Created by Matthew McCall on 5/13/22.
 //
 
-#include <utility>
-
-#include "Silicon/Types.hpp"
-#include "boost/uuid/uuid_hash.hpp"
-
 #include "Buffer.hpp"
-
-using AllocatorMapKey = std::pair<Si::NotNull<Si::Vulkan::Instance *>, Si::NotNull<Si::Vulkan::Device *>>;
-
-namespace {
-
-Si::Map<AllocatorMapKey, unsigned> s_referenceCount;
-Si::Map<AllocatorMapKey, VmaAllocator> s_allocators;
-
-}
+#include "MemoryAllocator.hpp"
 
 namespace Si::Vulkan {
 
-Buffer::Buffer(Instance &instance, Device &device, std::size_t size)
+Buffer::Buffer(Instance &instance, Device &device, std::size_t size, vk::BufferUsageFlags usage, HostAccess hostAccess)
     : m_instance(instance)
     , m_device(device)
     , m_size(size)
+    , m_usage(usage)
+    , m_hostAccess(hostAccess)
 {
     addDependency(m_instance);
     addDependency(m_device);
-
-    if (s_allocators.find({NotNull<Instance *>(&instance), NotNull<Device *>(&device)}) == s_allocators.end()) {
-
-        assert(!(s_referenceCount[{NotNull<Instance *>(&instance), NotNull<Device *>(&device)}]));
-
-        VmaAllocatorCreateInfo createInfo {};
-
-        createInfo.vulkanApiVersion = VK_API_VERSION_1_1;
-        createInfo.physicalDevice = *m_device.getPhysicalDevice();
-        createInfo.device = *m_device;
-        createInfo.instance = *m_instance;
-
-        vmaCreateAllocator(&createInfo, &s_allocators[{NotNull<Instance *>(&instance), NotNull<Device *>(&device)}]);
-    }
-
-    m_allocator = s_allocators[{NotNull<Instance *>(&instance), NotNull<Device *>(&device)}];
-    s_referenceCount[{NotNull<Instance *>(&instance), NotNull<Device *>(&device)}]++;
 }
 
 bool Buffer::createImpl()
 {
-    vk::BufferCreateInfo createInfo {{}, m_size, vk::BufferUsageFlagBits::eVertexBuffer, vk::SharingMode::eExclusive};
-
-    VmaAllocationCreateInfo allocationCreateInfo {
-        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
-        VMA_MEMORY_USAGE_AUTO,
-        static_cast<VkMemoryPropertyFlags>(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent)};
+    m_allocator = AcquireMemoryAllocator(m_instance, m_device);
+
+    vk::BufferCreateInfo createInfo {{}, m_size, m_usage, vk::SharingMode::eExclusive};
+
+    VmaAllocationCreateInfo allocationCreateInfo {};
+
+    allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocationCreateInfo.requiredFlags = static_cast<VkMemoryPropertyFlags>(vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent);
+
+    switch (m_hostAccess) {
+    case HostAccess::None:
+        allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        allocationCreateInfo.requiredFlags = 0;
+        break;
+    case HostAccess::SequentialWrite:
+        allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        break;
+    case HostAccess::Random:
+        // Reading uncached memory is painfully slow, so readback buffers prefer cached memory where there is some.
+        allocationCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        allocationCreateInfo.preferredFlags = static_cast<VkMemoryPropertyFlags>(vk::MemoryPropertyFlagBits::eHostCached);
+        break;
+    }
 
     vmaCreateBuffer(
         m_allocator,
@@ -69,11 +58,10 @@ bool Buffer::createImpl()
 void Buffer::destroyImpl()
 {
     vmaDestroyBuffer(m_allocator, m_handle, m_allocation);
-    s_referenceCount[{NotNull<Instance *>(&m_instance), NotNull<Device *>(&m_device)}]--;
+    ReleaseMemoryAllocator(m_instance, m_device);
 
-    if (!s_referenceCount[{NotNull<Instance *>(&m_instance), NotNull<Device *>(&m_device)}]) {
-        vmaDestroyAllocator(m_allocator);
-    }
+    m_allocator = nullptr;
+    m_allocation = nullptr;
 }
 
 }
@@ -18,15 +18,57 @@ namespace Si::Vulkan {
 class Buffer : public Handle<vk::Buffer>
 {
 public:
-    Buffer(Instance &instance, Device &device, std::size_t size);
+    /**
+     * How the CPU touches a buffer's mapped memory.
+     */
+    enum class HostAccess {
+        SequentialWrite, ///< Written front to back and never read, like vertex data or staging uploads.
+        Random, ///< Read back by the CPU, like the pixels of an offscreen render.
+        None ///< Not mapped at all and kept in device local memory. Filled with transfers, see StreamingBuffer.
+    };
+
+    Buffer(Instance &instance, Device &device, std::size_t size, vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eVertexBuffer, HostAccess hostAccess = HostAccess::SequentialWrite);
 
     template <typename T>
     void copyData(Vector<T> buffer)
     {
-        assert(isCreated());
+        assert(isCreated() && m_allocationInfo.pMappedData);
         std::memcpy(m_allocationInfo.pMappedData, buffer.data(), std::min(m_size, sizeof(buffer.front()) * buffer.size()));
     }
 
+    /**
+     * Copies bytes straight into the buffer's mapped memory, for example a MeshAsset's staging buffer.
+     *
+     * @param bytes The bytes to copy. Anything past the end of the buffer is dropped.
+     * @param offset Where in the buffer to copy to, in bytes.
+     */
+    void copyData(Span<const std::uint8_t> bytes, std::size_t offset = 0)
+    {
+        assert(isCreated() && m_allocationInfo.pMappedData && offset <= m_size);
+        std::memcpy(static_cast<std::uint8_t *>(m_allocationInfo.pMappedData) + offset, bytes.data(), std::min(m_size - offset, bytes.size()));
+    }
+
+    /**
+     * Gets the buffer's mapped memory for reading. Whatever wrote it on the GPU must have been waited on first.
+     *
+     * @return The contents of the buffer.
+     */
+    [[nodiscard]] Span<const std::uint8_t> getData() const
+    {
+        assert(isCreated() && m_allocationInfo.pMappedData);
+        return {static_cast<const std::uint8_t *>(m_allocationInfo.pMappedData), m_size};
+    }
+
+    [[nodiscard]] std::size_t getSize() const
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] vk::BufferUsageFlags getUsage() const
+    {
+        return m_usage;
+    }
+
 private:
     bool createImpl() override;
     void destroyImpl() override;
@@ -36,9 +78,11 @@ private:
 
     VmaAllocator m_allocator = nullptr;
     VmaAllocation m_allocation = nullptr;
-    VmaAllocationInfo m_allocationInfo;
+    VmaAllocationInfo m_allocationInfo {};
 
     std::size_t m_size;
+    vk::BufferUsageFlags m_usage;
+    HostAccess m_hostAccess;
 };
 
 }
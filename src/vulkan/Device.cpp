@@ -31,10 +31,151 @@
 //
 
 #include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
 #include <set>
 
+#include "spdlog/fmt/fmt.h"
+
+#include "Silicon/Log.hpp"
+
 #include "Device.hpp"
 #include "PhysicalDevice.hpp"
+#include "TemporaryPath.hpp"
+
+namespace {
+
+constexpr std::uint32_t PipelineCacheMagic = 0x43505349; // "ISPC"
+constexpr std::uint32_t PipelineCacheVersion = 1;
+
+/**
+ * Written before the driver's cache data. A cache is only loaded if it was saved by the same device and driver, since the driver would
+ * otherwise reject it anyway, or worse, not notice.
+ */
+struct PipelineCacheHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t vendorID;
+    std::uint32_t deviceID;
+    std::uint32_t driverVersion;
+    std::array<std::uint8_t, VK_UUID_SIZE> deviceUUID;
+    std::array<std::uint8_t, VK_UUID_SIZE> pipelineCacheUUID;
+    std::uint64_t dataSize;
+};
+
+std::mutex s_pipelineCacheDirectoryMutex;
+std::string s_pipelineCacheDirectory = "PipelineCache";
+
+bool Matches(const PipelineCacheHeader &a, const PipelineCacheHeader &b)
+{
+    return a.magic == b.magic && a.version == b.version && a.vendorID == b.vendorID && a.deviceID == b.deviceID && a.driverVersion == b.driverVersion && a.deviceUUID == b.deviceUUID && a.pipelineCacheUUID == b.pipelineCacheUUID;
+}
+
+PipelineCacheHeader GetPipelineCacheHeader(Si::Vulkan::PhysicalDevice &physicalDevice)
+{
+    auto properties = physicalDevice->getProperties2<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceIDProperties>();
+    const vk::PhysicalDeviceProperties &deviceProperties = properties.get<vk::PhysicalDeviceProperties2>().properties;
+    const vk::PhysicalDeviceIDProperties &idProperties = properties.get<vk::PhysicalDeviceIDProperties>();
+
+    PipelineCacheHeader header {PipelineCacheMagic, PipelineCacheVersion, deviceProperties.vendorID, deviceProperties.deviceID, deviceProperties.driverVersion};
+    std::copy(idProperties.deviceUUID.begin(), idProperties.deviceUUID.end(), header.deviceUUID.begin());
+    std::copy(deviceProperties.pipelineCacheUUID.begin(), deviceProperties.pipelineCacheUUID.end(), header.pipelineCacheUUID.begin());
+
+    return header;
+}
+
+std::string GetPipelineCachePath(const PipelineCacheHeader &header)
+{
+    std::string directory;
+
+    {
+        std::lock_guard<std::mutex> lock(s_pipelineCacheDirectoryMutex);
+        directory = s_pipelineCacheDirectory;
+    }
+
+    if (directory.empty()) {
+        return {};
+    }
+
+    std::string name = fmt::format("{:04x}-{:04x}-", header.vendorID, header.deviceID);
+
+    for (std::uint8_t byte : header.deviceUUID) {
+        name += fmt::format("{:02x}", byte);
+    }
+
+    return (std::filesystem::path(directory) / (name + ".bin")).string();
+}
+
+Si::Vector<std::uint8_t> ReadPipelineCache(const std::string &path, const PipelineCacheHeader &expected)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file) {
+        return {};
+    }
+
+    PipelineCacheHeader header {};
+
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || !Matches(header, expected)) {
+        Si::Engine::Info("Ignoring pipeline cache '{}', it was saved by another device or driver version", path);
+        return {};
+    }
+
+    // Checked before allocating, so a corrupt size can not ask for an arbitrary amount of memory.
+    std::error_code error;
+    std::uintmax_t fileSize = std::filesystem::file_size(path, error);
+
+    if (error || (fileSize < sizeof(header)) || (header.dataSize != fileSize - sizeof(header))) {
+        Si::Engine::Warn("Ignoring pipeline cache '{}', its size does not match its header", path);
+        return {};
+    }
+
+    Si::Vector<std::uint8_t> data(header.dataSize);
+
+    if (!file.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()))) {
+        Si::Engine::Warn("Ignoring truncated pipeline cache '{}'", path);
+        return {};
+    }
+
+    return data;
+}
+
+void WritePipelineCache(const std::string &path, PipelineCacheHeader header, const Si::Vector<std::uint8_t> &data)
+{
+    std::filesystem::path target(path);
+    std::error_code error;
+    std::filesystem::create_directories(target.parent_path(), error);
+
+    // Written under a temporary name and renamed into place, so a crash while saving never leaves a half written cache behind, and
+    // several instances saving at once never write into the same file.
+    std::filesystem::path temporary = Si::Vulkan::GetTemporaryPath(target);
+
+    header.dataSize = data.size();
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+
+        if (!file) {
+            Si::Engine::Warn("Failed to write pipeline cache '{}'", temporary.string());
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporary, target, error);
+
+    if (error) {
+        Si::Engine::Warn("Failed to write pipeline cache '{}': {}", path, error.message());
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+}
 
 namespace Si::Vulkan {
 
@@ -69,6 +210,26 @@ bool Device::createImpl()
     m_graphicsQueue = std::make_pair(m_physicalDevice.getGraphicsFamilyQueueIndex(), m_handle.getQueue(m_physicalDevice.getGraphicsFamilyQueueIndex(), 0));
     m_presentQueue = std::make_pair(m_physicalDevice.getPresentFamilyQueueIndex(), m_handle.getQueue(m_physicalDevice.getPresentFamilyQueueIndex(), 0));
 
+    const Vector<std::string> &extensions = m_physicalDevice.getEnabledExtensions();
+    m_pipelineCreationFeedback = std::find(extensions.begin(), extensions.end(), VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME) != extensions.end();
+
+    PipelineCacheHeader header = GetPipelineCacheHeader(m_physicalDevice);
+    m_pipelineCachePath = GetPipelineCachePath(header);
+
+    Vector<std::uint8_t> initialData;
+
+    if (!m_pipelineCachePath.empty()) {
+        initialData = ReadPipelineCache(m_pipelineCachePath, header);
+    }
+
+    vk::PipelineCacheCreateInfo pipelineCacheCreateInfo {{}, initialData.size(), initialData.data()};
+    m_pipelineCache = m_handle.createPipelineCache(pipelineCacheCreateInfo);
+    m_pipelineCacheLoadedSize = initialData.size();
+
+    if (!initialData.empty()) {
+        Engine::Debug("Loaded {} bytes of pipeline cache from '{}'", initialData.size(), m_pipelineCachePath);
+    }
+
     return true;
 }
 
@@ -79,6 +240,11 @@ PhysicalDevice &Device::getPhysicalDevice()
 
 void Device::destroyImpl()
 {
+    savePipelineCache();
+
+    m_handle.destroyPipelineCache(m_pipelineCache);
+    m_pipelineCache = nullptr;
+
     m_handle.destroy();
 }
 
@@ -102,4 +268,52 @@ vk::Queue Device::getPresentQueue() const
     return m_presentQueue.second;
 }
 
+vk::PipelineCache Device::getPipelineCache() const
+{
+    return m_pipelineCache;
+}
+
+void Device::savePipelineCache()
+{
+    if (!m_pipelineCache || m_pipelineCachePath.empty()) {
+        return;
+    }
+
+    Vector<std::uint8_t> data = m_handle.getPipelineCacheData<Allocator<std::uint8_t>>(m_pipelineCache);
+    WritePipelineCache(m_pipelineCachePath, GetPipelineCacheHeader(m_physicalDevice), data);
+
+    Engine::Debug("Saved {} bytes of pipeline cache to '{}'", data.size(), m_pipelineCachePath);
+}
+
+bool Device::hasPipelineCreationFeedback() const
+{
+    return m_pipelineCreationFeedback;
+}
+
+void Device::recordPipelineCreation(const vk::PipelineCreationFeedbackEXT *feedback)
+{
+    m_pipelines++;
+
+    if (!feedback || !(feedback->flags & vk::PipelineCreationFeedbackFlagBitsEXT::eValid)) {
+        return;
+    }
+
+    if (feedback->flags & vk::PipelineCreationFeedbackFlagBitsEXT::eApplicationPipelineCacheHit) {
+        m_pipelineCacheHits++;
+    } else {
+        m_pipelineCacheMisses++;
+    }
+}
+
+Device::PipelineCacheStats Device::getPipelineCacheStats() const
+{
+    return {m_pipelines, m_pipelineCacheHits, m_pipelineCacheMisses, m_pipelineCacheLoadedSize};
+}
+
+void Device::setPipelineCacheDirectory(const std::string &directory)
+{
+    std::lock_guard<std::mutex> lock(s_pipelineCacheDirectoryMutex);
+    s_pipelineCacheDirectory = directory;
+}
+
 }
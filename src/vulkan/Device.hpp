@@ -33,6 +33,8 @@
 #ifndef YORK_VULKAN_DEVICE_HPP
 #define YORK_VULKAN_DEVICE_HPP
 
+#include <atomic>
+#include <string>
 #include <utility>
 
 #include <vulkan/vulkan.hpp>
@@ -63,6 +65,17 @@ using DeviceExtension = RequestableItem;
 class Device : public Handle<vk::Device>
 {
 public:
+    struct PipelineCacheStats {
+        /// Pipelines created with the pipeline cache.
+        std::uint64_t pipelines;
+        /// Pipelines the driver found in the cache. Only reported with VK_EXT_pipeline_creation_feedback.
+        std::uint64_t hits;
+        /// Pipelines the driver had to compile. Only reported with VK_EXT_pipeline_creation_feedback.
+        std::uint64_t misses;
+        /// Bytes of cache data loaded from disk when the device was created.
+        std::size_t loadedSize;
+    };
+
     /**
      * @brief Initializes a GPU device
      *
@@ -105,6 +118,45 @@ public:
      */
     [[nodiscard]] vk::Queue getPresentQueue() const;
 
+    /**
+     * @brief Gets the pipeline cache shared by every pipeline created on the device.
+     *
+     * It is loaded from disk when the device is created, if a cache was saved by the same device and driver version.
+     *
+     * @return The pipeline cache.
+     */
+    [[nodiscard]] vk::PipelineCache getPipelineCache() const;
+
+    /**
+     * Writes the pipeline cache to disk, so the next launch can skip compiling pipelines the driver has seen before. Also called when
+     * the device is destroyed.
+     */
+    void savePipelineCache();
+
+    /**
+     * Gets whether pipelines can report if they were found in the cache, which needs VK_EXT_pipeline_creation_feedback.
+     *
+     * @return Whether pipeline creation feedback is enabled.
+     */
+    [[nodiscard]] bool hasPipelineCreationFeedback() const;
+
+    /**
+     * Counts a pipeline created with the pipeline cache. Safe to call from several threads at once.
+     *
+     * @param feedback The driver's feedback on the pipeline, if pipeline creation feedback is enabled.
+     */
+    void recordPipelineCreation(const vk::PipelineCreationFeedbackEXT *feedback);
+
+    [[nodiscard]] PipelineCacheStats getPipelineCacheStats() const;
+
+    /**
+     * Sets the directory pipeline caches are saved in, which is created if needed. Each device and driver gets a file of its own.
+     * Defaults to "PipelineCache" in the working directory.
+     *
+     * @param directory The directory to save in, or an empty string to start every launch with an empty cache.
+     */
+    static void setPipelineCacheDirectory(const std::string &directory);
+
 protected:
     bool createImpl() override;
     void destroyImpl() override;
@@ -114,6 +166,15 @@ private:
 
     IndexQueuePair m_graphicsQueue;
     IndexQueuePair m_presentQueue;
+
+    vk::PipelineCache m_pipelineCache;
+    std::string m_pipelineCachePath;
+    std::size_t m_pipelineCacheLoadedSize = 0;
+    bool m_pipelineCreationFeedback = false;
+
+    std::atomic<std::uint64_t> m_pipelines {0};
+    std::atomic<std::uint64_t> m_pipelineCacheHits {0};
+    std::atomic<std::uint64_t> m_pipelineCacheMisses {0};
 };
 
 }
@@ -38,25 +38,41 @@ Framebuffer::Framebuffer(RenderPass &renderPass, ImageView &imageView, SwapChain
     : m_renderPass(renderPass)
     , m_imageView(imageView)
     , m_device(m_renderPass.getDevice())
-    , m_swapChain(swapChain)
+    , m_swapChain(&swapChain)
+{
+    assert(&m_renderPass.getDevice() == &m_imageView.getDevice());
+
+    addDependency(m_renderPass);
+    addDependency(m_imageView);
+    addDependency(*m_swapChain);
+}
+
+Framebuffer::Framebuffer(RenderPass &renderPass, ImageView &imageView, vk::Extent2D extent)
+    : m_renderPass(renderPass)
+    , m_imageView(imageView)
+    , m_device(m_renderPass.getDevice())
+    , m_extent(extent)
 {
     assert(&m_renderPass.getDevice() == &m_imageView.getDevice());
 
     addDependency(m_renderPass);
     addDependency(m_imageView);
-    addDependency(m_swapChain);
 }
 
 bool Framebuffer::createImpl()
 {
     std::array<vk::ImageView, 1> attachments {*m_imageView};
 
+    if (m_swapChain) {
+        m_extent = m_swapChain->getExtent();
+    }
+
     vk::FramebufferCreateInfo framebufferCreateInfo {
         {},
         *m_renderPass,
         attachments,
-        m_swapChain.getExtent().width,
-        m_swapChain.getExtent().height,
+        m_extent.width,
+        m_extent.height,
         1};
 
     m_handle = m_device->createFramebuffer(framebufferCreateInfo);
@@ -49,6 +49,15 @@ class Framebuffer : public Handle<vk::Framebuffer>
 public:
     explicit Framebuffer(RenderPass &renderPass, ImageView &imageView, SwapChain &swapChain);
 
+    /**
+     * Creates a framebuffer of a fixed size, for rendering without a swap chain.
+     *
+     * @param renderPass The render pass the framebuffer is used with.
+     * @param imageView The view of the image to render to.
+     * @param extent The size of the framebuffer.
+     */
+    Framebuffer(RenderPass &renderPass, ImageView &imageView, vk::Extent2D extent);
+
 protected:
     bool createImpl() override;
     void destroyImpl() override;
@@ -57,7 +66,8 @@ private:
     RenderPass &m_renderPass;
     ImageView &m_imageView;
     Device &m_device;
-    SwapChain &m_swapChain;
+    SwapChain *m_swapChain = nullptr;
+    vk::Extent2D m_extent;
 };
 
 }
@@ -26,8 +26,23 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <numeric>
+#include <unordered_map>
+
+#include "Silicon/Async.hpp"
+
 #include "Handle.hpp"
 
+namespace {
+
+// Guards the dependency lists of every handle, since handles created in parallel may add dependencies of their own.
+std::mutex s_graphMutex;
+
+}
+
 namespace Si::Vulkan {
 
 #pragma clang diagnostic push
@@ -36,53 +51,169 @@ namespace Si::Vulkan {
 HandleBase::HandleBase(const HandleBase &other)
     : m_mutex()
 {
-    for (HandleBase *dependency : other.m_dependencies) {
+    Vector<HandleBase *> dependencies;
+
+    {
+        std::lock_guard<std::mutex> lock(s_graphMutex);
+        dependencies.assign(other.m_dependencies.begin(), other.m_dependencies.end());
+    }
+
+    for (HandleBase *dependency : dependencies) {
         addDependency(*dependency);
     }
 }
 
 void HandleBase::create()
 {
-    Vector<std::reference_wrapper<HandleBase>> destroyedDependents;
-    destroyedDependents.reserve(m_dependents.size());
+    if (!m_created) {
+        Vector<HandleBase *> dependencies;
 
-    for (HandleBase *dependent : m_dependents) {
-        if (dependent->isCreated()) {
-            destroyedDependents.emplace_back(*dependent);
+        {
+            std::lock_guard<std::mutex> lock(s_graphMutex);
+            dependencies.assign(m_dependencies.begin(), m_dependencies.end());
+        }
+
+        for (HandleBase *dependency : dependencies) {
+            if (!dependency->isCreated()) {
+                dependency->create();
+            }
         }
+
+        assert(!m_created); // If this has been created during dependency creation we may have a loop.
+        m_created = this->createImpl();
+        return;
+    }
+
+    std::array<HandleBase *, 1> roots {this};
+    recreate(roots);
+}
+
+void HandleBase::recreate(Span<HandleBase *const> roots)
+{
+    for (HandleBase *root : roots) {
+        assert(root->isCreated()); // Only created handles can be recreated, create the others first.
     }
 
-    this->destroy();
+    Tagged<MemoryTag::Renderer>::Vector<Level> levels = getInvalidatedLevels(roots);
 
-    for (HandleBase *dependency : m_dependencies) {
-        if (!dependency->isCreated()) {
-            dependency->create();
+    for (auto level = levels.rbegin(); level != levels.rend(); level++) {
+        for (HandleBase *handle : *level) {
+            handle->destroyImpl();
+            handle->m_created = false;
         }
     }
 
-    assert(!m_created); // If this has been created during dependency creation we may have a loop.
-    m_created = this->createImpl();
+    for (Level &level : levels) {
+        // Running a taskflow from one of the executor's own workers and waiting on it could leave every worker waiting.
+        if ((level.size() < 2) || (GetAsyncExecutor().this_worker_id() >= 0)) {
+            for (HandleBase *handle : level) {
+                handle->m_created = handle->createImpl();
+            }
+
+            continue;
+        }
 
-    for (HandleBase &destroyedDependent : destroyedDependents) {
-        destroyedDependent.create();
+        tf::Taskflow taskflow;
+
+        for (HandleBase *handle : level) {
+            taskflow.emplace([handle]() {
+                handle->m_created = handle->createImpl();
+            });
+        }
+
+        GetAsyncExecutor().run(taskflow).wait();
     }
 }
 
 void HandleBase::destroy()
 {
-    for (HandleBase *dependent : m_dependents) {
-        dependent->destroy();
-    }
+    std::array<HandleBase *, 1> roots {this};
+    Tagged<MemoryTag::Renderer>::Vector<Level> levels = getInvalidatedLevels(roots);
 
-    if (m_created) {
-        this->destroyImpl();
-    }
+    for (auto level = levels.rbegin(); level != levels.rend(); level++) {
+        for (HandleBase *handle : *level) {
+            if (handle->m_created) {
+                handle->destroyImpl();
+            }
 
-    m_created = false;
+            handle->m_created = false;
+        }
+    }
 }
 
 #pragma clang diagnostic pop
 
+Tagged<MemoryTag::Renderer>::Vector<HandleBase::Level> HandleBase::getInvalidatedLevels(Span<HandleBase *const> roots)
+{
+    std::lock_guard<std::mutex> lock(s_graphMutex);
+
+    // For each invalidated handle, how many of its dependencies are invalidated and not yet placed on a level.
+    std::unordered_map<HandleBase *, std::size_t> pendingDependencies;
+    Level stack(roots.begin(), roots.end());
+
+    for (HandleBase *root : roots) {
+        pendingDependencies[root] = 0;
+    }
+
+    while (!stack.empty()) {
+        HandleBase *handle = stack.back();
+        stack.pop_back();
+
+        for (HandleBase *dependent : handle->m_dependents) {
+            if (dependent->isCreated() && !pendingDependencies.count(dependent)) {
+                pendingDependencies[dependent] = 0;
+                stack.push_back(dependent);
+            }
+        }
+    }
+
+    // A root may depend on another root, so roots are placed by their dependencies like any other handle.
+    Level first;
+
+    for (auto &[handle, count] : pendingDependencies) {
+        count = std::count_if(handle->m_dependencies.begin(), handle->m_dependencies.end(), [&pendingDependencies](HandleBase *dependency) {
+            return pendingDependencies.count(dependency);
+        });
+
+        if (!count) {
+            first.push_back(handle);
+        }
+    }
+
+    Tagged<MemoryTag::Renderer>::Vector<Level> levels;
+
+    if (!first.empty()) {
+        levels.push_back(std::move(first));
+    }
+
+    while (!levels.empty()) {
+        Level next;
+
+        for (HandleBase *handle : levels.back()) {
+            for (HandleBase *dependent : handle->m_dependents) {
+                auto pending = pendingDependencies.find(dependent);
+
+                if ((pending != pendingDependencies.end()) && !--pending->second) {
+                    next.push_back(dependent);
+                }
+            }
+        }
+
+        if (next.empty()) {
+            break;
+        }
+
+        levels.push_back(std::move(next));
+    }
+
+    // Handles on a dependency cycle never run out of pending dependencies, so they would be destroyed and never recreated.
+    assert(std::accumulate(levels.begin(), levels.end(), std::size_t {0}, [](std::size_t count, const Level &level) {
+        return count + level.size();
+    }) == pendingDependencies.size());
+
+    return levels;
+}
+
 bool HandleBase::isCreated() const
 {
     return m_created;
@@ -90,11 +221,14 @@ bool HandleBase::isCreated() const
 
 void HandleBase::addDependent(HandleBase &handle)
 {
+    std::lock_guard<std::mutex> lock(s_graphMutex);
     m_dependents.emplace_back(&handle);
 }
 
 void HandleBase::removeDependent(HandleBase &handle)
 {
+    std::lock_guard<std::mutex> lock(s_graphMutex);
+
     auto i = std::find_if(m_dependents.begin(), m_dependents.end(), [&handle](auto other) {
         return &handle == other;
     });
@@ -107,6 +241,8 @@ void HandleBase::removeDependent(HandleBase &handle)
 void HandleBase::addDependency(HandleBase &handle)
 {
     handle.addDependent(*this);
+
+    std::lock_guard<std::mutex> lock(s_graphMutex);
     m_dependencies.emplace_back(&handle);
 }
 
@@ -114,6 +250,8 @@ void HandleBase::removeDependency(HandleBase &handle)
 {
     handle.removeDependent(*this);
 
+    std::lock_guard<std::mutex> lock(s_graphMutex);
+
     auto i = std::find_if(m_dependencies.begin(), m_dependencies.end(), [&handle](auto other) {
         return other == &handle;
     });
@@ -128,11 +266,29 @@ HandleBase::~HandleBase()
     while (m_dependencies.begin() != m_dependencies.end()) {
         removeDependency(*m_dependencies.front());
     }
+
+    // Dependents that outlive this handle must not keep pointing at it.
+    std::lock_guard<std::mutex> lock(s_graphMutex);
+
+    for (HandleBase *dependent : m_dependents) {
+        auto i = std::find(dependent->m_dependencies.begin(), dependent->m_dependencies.end(), this);
+
+        if (i != dependent->m_dependencies.end()) {
+            dependent->m_dependencies.erase(i);
+        }
+    }
 }
 
 HandleBase &HandleBase::operator=(const HandleBase &other)
 {
-    for (HandleBase *dependency : other.m_dependencies) {
+    Vector<HandleBase *> dependencies;
+
+    {
+        std::lock_guard<std::mutex> lock(s_graphMutex);
+        dependencies.assign(other.m_dependencies.begin(), other.m_dependencies.end());
+    }
+
+    for (HandleBase *dependency : dependencies) {
         addDependency(*dependency);
     }
 
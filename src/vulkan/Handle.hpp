@@ -37,6 +37,7 @@
  * Credit to <a href="https://github.com/MarcasRealAccount/">Markus</a> for the Handle system.
  */
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 
@@ -59,11 +60,25 @@ public:
      * @brief Creates a handle.
      *
      * If a handle is is created, it will be destroyed, including its dependents, then recreated, including its dependents.
+     *
+     * Only dependents that are created are recreated, each exactly once. They are destroyed in reverse topological order, then recreated
+     * a level at a time, where a level holds the handles whose dependencies are all on earlier levels. Handles on the same level do not
+     * depend on each other, so they are created in parallel on the async executor.
      */
     void create();
 
     /**
-     * Destroys a handle, including its dependents.
+     * @brief Recreates several handles and their dependents in a single pass.
+     *
+     * Recreating the handles one after another would recreate a dependent they share once for each of them. Here the dependents of
+     * every root are merged into one set, so each is destroyed and recreated exactly once, in the same levels as create.
+     *
+     * @param roots The handles to recreate, which must all be created. A root may depend on another root.
+     */
+    static void recreate(Span<HandleBase *const> roots);
+
+    /**
+     * Destroys a handle, including its dependents, in reverse topological order.
      */
     void destroy();
 
@@ -102,12 +117,21 @@ protected:
     virtual void destroyImpl() = 0;
 
 private:
-    bool m_created = false;
+    using Level = Tagged<MemoryTag::Renderer>::Vector<HandleBase *>;
+
+    /**
+     * Gets the roots and every created handle that depends on one of them, directly or not, grouped into levels. Every handle is on
+     * a later level than all of its dependencies in the set.
+     */
+    static Tagged<MemoryTag::Renderer>::Vector<Level> getInvalidatedLevels(Span<HandleBase *const> roots);
+
+    // Read by handles being created in parallel on other threads.
+    std::atomic<bool> m_created {false};
     std::recursive_mutex m_mutex;
 
 private:
-    Vector<NotNull<HandleBase *>> m_dependents;
-    Vector<NotNull<HandleBase *>> m_dependencies;
+    Tagged<MemoryTag::Renderer>::Vector<NotNull<HandleBase *>> m_dependents;
+    Tagged<MemoryTag::Renderer>::Vector<NotNull<HandleBase *>> m_dependencies;
 };
 
 /**
@@ -124,7 +148,7 @@ public:
      *
      * @return The handle.
      */
-    T getHandle()
+    T getHandle() const
     {
         return m_handle;
     }
@@ -0,0 +1,105 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/24/23.
+//
+
+#include "Image.hpp"
+#include "MemoryAllocator.hpp"
+
+namespace Si::Vulkan {
+
+Image::Image(Instance &instance, Device &device, vk::Extent2D extent, vk::Format format, vk::ImageUsageFlags usage)
+    : m_instance(instance)
+    , m_device(device)
+    , m_extent(extent)
+    , m_format(format)
+    , m_usage(usage)
+{
+    addDependency(m_instance);
+    addDependency(m_device);
+}
+
+bool Image::createImpl()
+{
+    m_allocator = AcquireMemoryAllocator(m_instance, m_device);
+
+    vk::ImageCreateInfo createInfo {
+        {},
+        vk::ImageType::e2D,
+        m_format,
+        {m_extent.width, m_extent.height, 1},
+        1,
+        1,
+        vk::SampleCountFlagBits::e1,
+        vk::ImageTiling::eOptimal,
+        m_usage,
+        vk::SharingMode::eExclusive,
+        {},
+        vk::ImageLayout::eUndefined};
+
+    VmaAllocationCreateInfo allocationCreateInfo {};
+    allocationCreateInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+
+    vmaCreateImage(
+        m_allocator,
+        reinterpret_cast<const VkImageCreateInfo *>(&createInfo),
+        &allocationCreateInfo,
+        reinterpret_cast<VkImage *>(&m_handle),
+        &m_allocation,
+        nullptr);
+
+    return true;
+}
+
+void Image::destroyImpl()
+{
+    vmaDestroyImage(m_allocator, m_handle, m_allocation);
+    ReleaseMemoryAllocator(m_instance, m_device);
+
+    m_allocator = nullptr;
+    m_allocation = nullptr;
+}
+
+Device &Image::getDevice() const
+{
+    return m_device;
+}
+
+const vk::Extent2D &Image::getExtent() const
+{
+    return m_extent;
+}
+
+vk::Format Image::getFormat() const
+{
+    return m_format;
+}
+
+}
@@ -0,0 +1,75 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/24/23.
+//
+
+#ifndef YORK_VULKAN_IMAGE_HPP
+#define YORK_VULKAN_IMAGE_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include "Device.hpp"
+#include "Handle.hpp"
+#include "Instance.hpp"
+#include "vk_mem_alloc.h"
+
+namespace Si::Vulkan {
+
+/**
+ * Handle wrapper for a device local 2D Vulkan Image allocated through VMA, such as an offscreen render target.
+ */
+class Image : public Handle<vk::Image>
+{
+public:
+    Image(Instance &instance, Device &device, vk::Extent2D extent, vk::Format format, vk::ImageUsageFlags usage);
+
+    [[nodiscard]] Device &getDevice() const;
+    [[nodiscard]] const vk::Extent2D &getExtent() const;
+    [[nodiscard]] vk::Format getFormat() const;
+
+protected:
+    bool createImpl() override;
+    void destroyImpl() override;
+
+private:
+    Instance &m_instance;
+    Device &m_device;
+
+    VmaAllocator m_allocator = nullptr;
+    VmaAllocation m_allocation = nullptr;
+
+    vk::Extent2D m_extent;
+    vk::Format m_format;
+    vk::ImageUsageFlags m_usage;
+};
+
+}
+
+#endif // YORK_VULKAN_IMAGE_HPP
@@ -42,8 +42,20 @@ ImageView::ImageView(Device &device, vk::Format format, vk::Image image)
     addDependency(m_device);
 }
 
+ImageView::ImageView(Image &image)
+    : m_device(image.getDevice())
+    , m_format(image.getFormat())
+    , m_source(&image)
+{
+    addDependency(image);
+}
+
 bool ImageView::createImpl()
 {
+    if (m_source) {
+        m_image = **m_source;
+    }
+
     vk::ImageViewCreateInfo imageViewCreateInfo {
         {},
         m_image,
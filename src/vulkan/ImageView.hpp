@@ -35,6 +35,7 @@
 
 #include "Device.hpp"
 #include "Handle.hpp"
+#include "Image.hpp"
 
 #include <vulkan/vulkan.hpp>
 
@@ -47,6 +48,13 @@ class ImageView : public Handle<vk::ImageView>
 {
 public:
     ImageView(Device &device, vk::Format format, vk::Image image);
+
+    /**
+     * Creates a view of an Image owned by the engine. The view is recreated along with the image.
+     *
+     * @param image The image to view.
+     */
+    explicit ImageView(Image &image);
     [[nodiscard]] Device &getDevice() const;
 
 protected:
@@ -58,6 +66,7 @@ private:
     Device &m_device;
     vk::Format m_format;
     vk::Image m_image;
+    Image *m_source = nullptr;
 };
 
 }
@@ -69,6 +69,11 @@ VKAPI_ATTR VkBool32 VKAPI_CALL debugMessageFunc(VkDebugUtilsMessageSeverityFlagB
 
 namespace Si::Vulkan {
 
+Instance::Instance(bool headless)
+    : m_headless(headless)
+{
+}
+
 bool Instance::createImpl()
 {
     vk::ApplicationInfo appInfo {"York Engine Client", VK_MAKE_VERSION(1, 0, 0), "York Engine", VK_MAKE_VERSION(1, 0, 0), VK_API_VERSION_1_1};
@@ -112,7 +117,7 @@ bool Instance::createImpl()
 
     Vector<const char *> sdlExtensions;
 
-    {
+    if (!m_headless) {
         // TODO: Remove when SDL updates their API
         SDL_Window *window = SDL_CreateWindow("York Engine", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 800, 600, SDL_WINDOW_ALLOW_HIGHDPI | SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE);
         unsigned extensionCount;
@@ -211,6 +216,11 @@ bool Instance::createImpl()
     return true;
 }
 
+bool Instance::isHeadless() const
+{
+    return m_headless;
+}
+
 void Instance::requestLayer(const InstanceLayer &layer)
 {
     m_requestedLayers.push_back(layer);
@@ -56,9 +56,17 @@ public:
     /**
      * Creates a Vulkan instance.
      *
-     * @param window The window which we will be drawing to.
+     * @param headless Whether the instance only renders offscreen. A headless instance does not ask SDL for the window system
+     * extensions, so it works without a display, for example with a software ICD on a CI machine.
      */
-    explicit Instance() = default;
+    explicit Instance(bool headless = false);
+
+    /**
+     * Gets whether the instance only renders offscreen.
+     *
+     * @return Whether the instance is headless.
+     */
+    [[nodiscard]] bool isHeadless() const;
 
 protected:
     bool createImpl() override;
@@ -85,6 +93,7 @@ protected:
 
 private:
     vk::DebugUtilsMessengerEXT debugUtilsMessenger = {};
+    bool m_headless;
     Vector<InstanceLayer> m_requestedLayers;
     Vector<InstanceExtension> m_requestedExtensions;
 };
@@ -0,0 +1,105 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/24/23.
+//
+
+#include <mutex>
+#include <utility>
+
+#include "Silicon/MemoryTracking.hpp"
+#include "Silicon/Types.hpp"
+
+#include "MemoryAllocator.hpp"
+
+using AllocatorMapKey = std::pair<Si::NotNull<Si::Vulkan::Instance *>, Si::NotNull<Si::Vulkan::Device *>>;
+
+namespace {
+
+// Handles on the same level of the dependency graph are created in parallel, so buffers and images may acquire at the same time.
+std::mutex s_allocatorMutex;
+
+Si::Tagged<Si::MemoryTag::Renderer>::Map<AllocatorMapKey, unsigned> s_referenceCount;
+Si::Tagged<Si::MemoryTag::Renderer>::Map<AllocatorMapKey, VmaAllocator> s_allocators;
+
+// Device memory blocks are what VMA actually takes from the driver, so they are what is accounted to the GPU.
+void VKAPI_PTR OnDeviceMemoryAllocate(VmaAllocator, std::uint32_t, VkDeviceMemory, VkDeviceSize size, void *)
+{
+    Si::TrackAllocation(Si::MemoryTag::GPU, size);
+}
+
+void VKAPI_PTR OnDeviceMemoryFree(VmaAllocator, std::uint32_t, VkDeviceMemory, VkDeviceSize size, void *)
+{
+    Si::TrackDeallocation(Si::MemoryTag::GPU, size);
+}
+
+const VmaDeviceMemoryCallbacks s_deviceMemoryCallbacks {OnDeviceMemoryAllocate, OnDeviceMemoryFree, nullptr};
+
+}
+
+namespace Si::Vulkan {
+
+VmaAllocator AcquireMemoryAllocator(Instance &instance, Device &device)
+{
+    AllocatorMapKey key {NotNull<Instance *>(&instance), NotNull<Device *>(&device)};
+    std::lock_guard<std::mutex> lock(s_allocatorMutex);
+
+    if (s_allocators.find(key) == s_allocators.end()) {
+
+        assert(!(s_referenceCount[key]));
+
+        VmaAllocatorCreateInfo createInfo {};
+
+        createInfo.vulkanApiVersion = VK_API_VERSION_1_1;
+        createInfo.physicalDevice = *device.getPhysicalDevice();
+        createInfo.device = *device;
+        createInfo.instance = *instance;
+        createInfo.pDeviceMemoryCallbacks = &s_deviceMemoryCallbacks;
+
+        vmaCreateAllocator(&createInfo, &s_allocators[key]);
+    }
+
+    s_referenceCount[key]++;
+    return s_allocators[key];
+}
+
+void ReleaseMemoryAllocator(Instance &instance, Device &device)
+{
+    AllocatorMapKey key {NotNull<Instance *>(&instance), NotNull<Device *>(&device)};
+    std::lock_guard<std::mutex> lock(s_allocatorMutex);
+
+    assert(s_referenceCount[key]);
+
+    if (!--s_referenceCount[key]) {
+        vmaDestroyAllocator(s_allocators[key]);
+        s_allocators.erase(key);
+    }
+}
+
+}
@@ -0,0 +1,63 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/24/23.
+//
+
+#ifndef YORK_VULKAN_MEMORYALLOCATOR_HPP
+#define YORK_VULKAN_MEMORYALLOCATOR_HPP
+
+#include "Device.hpp"
+#include "Instance.hpp"
+#include "vk_mem_alloc.h"
+
+namespace Si::Vulkan {
+
+/**
+ * @brief Gets the VMA allocator shared by every Buffer and Image of a device, creating it on first use.
+ *
+ * Each call must be matched by a call to ReleaseMemoryAllocator once the resource has been destroyed.
+ *
+ * @param instance The instance the device belongs to.
+ * @param device The device to allocate memory from.
+ * @return The allocator for the device.
+ */
+VmaAllocator AcquireMemoryAllocator(Instance &instance, Device &device);
+
+/**
+ * @brief Releases an allocator acquired with AcquireMemoryAllocator, destroying it once the last user is gone.
+ *
+ * @param instance The instance the device belongs to.
+ * @param device The device the allocator was acquired for.
+ */
+void ReleaseMemoryAllocator(Instance &instance, Device &device);
+
+}
+
+#endif // YORK_VULKAN_MEMORYALLOCATOR_HPP
@@ -40,7 +40,7 @@
 
 namespace Si::Vulkan {
 
-PhysicalDevice::PhysicalDevice(vk::PhysicalDevice device, Surface &surface, Vector<RequestableItem> &requestedExtensions)
+PhysicalDevice::PhysicalDevice(vk::PhysicalDevice device, Surface *surface, Vector<RequestableItem> &requestedExtensions)
     : m_physicalDevice(device)
     , m_surface(surface)
 {
@@ -51,11 +51,11 @@ PhysicalDevice::PhysicalDevice(vk::PhysicalDevice device, Surface &surface, Vect
             if (requestedExtension.name == availableExtension.extensionName) {
                 if (requestedExtension.required) {
                     m_requiredExtensionsSupported++;
-                    m_enabledExtensions.emplace_back(availableExtension.extensionName.begin(), availableExtension.extensionName.end());
+                    m_enabledExtensions.emplace_back(availableExtension.extensionName.data());
                     break;
                 }
                 m_optionalExtensionsSupported++;
-                m_enabledExtensions.emplace_back(availableExtension.extensionName.begin(), availableExtension.extensionName.end());
+                m_enabledExtensions.emplace_back(availableExtension.extensionName.data());
                 break;
             }
         }
@@ -73,11 +73,15 @@ PhysicalDevice::PhysicalDevice(vk::PhysicalDevice device, Surface &surface, Vect
 
     m_maximumImageResolution = device.getProperties().limits.maxImageDimension2D;
 
-    m_formats = m_physicalDevice.getSurfaceFormatsKHR<Allocator<vk::SurfaceFormatKHR>>(*surface);
-    Vector<vk::PresentModeKHR> presentModes = m_physicalDevice.getSurfacePresentModesKHR<Allocator<vk::PresentModeKHR>>(*surface);
-
     m_presentBestMode = vk::PresentModeKHR::eFifo;
 
+    if (!m_surface) {
+        return;
+    }
+
+    m_formats = m_physicalDevice.getSurfaceFormatsKHR<Allocator<vk::SurfaceFormatKHR>>(**m_surface);
+    Vector<vk::PresentModeKHR> presentModes = m_physicalDevice.getSurfacePresentModesKHR<Allocator<vk::PresentModeKHR>>(**m_surface);
+
     for (auto &availablePresentMode : presentModes) {
         if (availablePresentMode == vk::PresentModeKHR::eMailbox) {
             m_presentBestMode = availablePresentMode;
@@ -107,9 +111,13 @@ uint32_t PhysicalDevice::getGraphicsFamilyQueueIndex() const
 
 uint32_t PhysicalDevice::getPresentFamilyQueueIndex()
 {
+    if (!m_surface) {
+        return m_graphicsFamilyQueueIndex;
+    }
+
     unsigned int presentQueueFamilyIndex = 0;
     for (const vk::QueueFamilyProperties &queueFamily : m_queueFamilyProperties) {
-        if (m_physicalDevice.getSurfaceSupportKHR(presentQueueFamilyIndex, *m_surface) == VK_TRUE) {
+        if (m_physicalDevice.getSurfaceSupportKHR(presentQueueFamilyIndex, **m_surface) == VK_TRUE) {
             m_presentFamilyQueueIndex = presentQueueFamilyIndex;
             break;
         }
@@ -128,7 +136,7 @@ uint32_t PhysicalDevice::getMaximumImageResolution() const
 {
     return m_maximumImageResolution;
 }
-std::optional<PhysicalDevice> PhysicalDevice::getBest(Instance &instance, Surface &surface, Vector<RequestableItem> requestedExtensions)
+std::optional<PhysicalDevice> PhysicalDevice::getBest(Instance &instance, Surface *surface, Vector<RequestableItem> requestedExtensions)
 {
     Vector<vk::PhysicalDevice> physicalDevices = instance->enumeratePhysicalDevices<Allocator<vk::PhysicalDevice>>();
 
@@ -183,13 +191,14 @@ std::optional<PhysicalDevice> PhysicalDevice::getBest(Instance &instance, Surfac
 
 vk::SurfaceCapabilitiesKHR PhysicalDevice::getSurfaceCapabilities()
 {
-    return m_physicalDevice.getSurfaceCapabilitiesKHR(*m_surface);
-    ;
+    assert(m_surface);
+    return m_physicalDevice.getSurfaceCapabilitiesKHR(**m_surface);
 }
 
 Vector<vk::SurfaceFormatKHR> &PhysicalDevice::getFormats()
 {
-    m_formats = m_physicalDevice.getSurfaceFormatsKHR<Allocator<vk::SurfaceFormatKHR>>(*m_surface);
+    assert(m_surface);
+    m_formats = m_physicalDevice.getSurfaceFormatsKHR<Allocator<vk::SurfaceFormatKHR>>(**m_surface);
     return m_formats;
 }
 
@@ -219,7 +228,7 @@ PhysicalDevice &PhysicalDevice::operator=(const PhysicalDevice &rhs)
     return *this;
 }
 
-Surface &PhysicalDevice::getSurface() const
+Surface *PhysicalDevice::getSurface() const
 {
     return m_surface;
 }
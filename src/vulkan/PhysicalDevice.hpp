@@ -56,9 +56,10 @@ public:
      * Creates a class representing information about a specific GPU.
      *
      * @param device The Vulkan handle for the physical device to get the information about.
+     * @param surface The surface that will be presented to, or nullptr when rendering offscreen.
      * @param requestedExtensions The extensions to check against this device's support for.
      */
-    PhysicalDevice(vk::PhysicalDevice device, Surface &surface, Vector<RequestableItem> &requestedExtensions);
+    PhysicalDevice(vk::PhysicalDevice device, Surface *surface, Vector<RequestableItem> &requestedExtensions);
 
     /**
      * Gets the number of requested required extensions supported.
@@ -88,6 +89,11 @@ public:
      */
     [[nodiscard]] uint32_t getGraphicsFamilyQueueIndex() const;
 
+    /**
+     * Gets the index of a queue that can present to the surface. Without a surface nothing is presented, so this is the graphics queue.
+     *
+     * @return The index of the present queue of the device.
+     */
     [[nodiscard]] uint32_t getPresentFamilyQueueIndex();
 
     /**
@@ -110,7 +116,12 @@ public:
     [[nodiscard]] vk::SurfaceFormatKHR getBestFormat();
     [[nodiscard]] vk::PresentModeKHR getBestPresentMode() const;
 
-    [[nodiscard]] Surface &getSurface() const;
+    /**
+     * Gets the surface the device presents to.
+     *
+     * @return The surface, or nullptr for an offscreen device.
+     */
+    [[nodiscard]] Surface *getSurface() const;
 
     /**
      * @brief Returns the best physical device.
@@ -120,10 +131,11 @@ public:
      * resolutions.
      *
      * @param instance The instance to get the physical devices from.
+     * @param surface The surface that will be presented to, or nullptr when rendering offscreen.
      * @param requestedExtensions The extensions to check the devices against.
      * @return
      */
-    static std::optional<PhysicalDevice> getBest(Instance &instance, Surface &surface, Vector<RequestableItem> requestedExtensions);
+    static std::optional<PhysicalDevice> getBest(Instance &instance, Surface *surface, Vector<RequestableItem> requestedExtensions);
 
     vk::PhysicalDevice *operator->();
     vk::PhysicalDevice &operator*();
@@ -133,7 +145,7 @@ private:
     unsigned m_requiredExtensionsSupported = 0;
     unsigned m_optionalExtensionsSupported = 0;
 
-    Surface &m_surface;
+    Surface *m_surface;
 
     vk::PhysicalDevice m_physicalDevice;
     vk::PresentModeKHR m_presentBestMode;
@@ -30,13 +30,37 @@
 // Created by Matthew McCall on 1/3/22.
 //
 
+#include <algorithm>
 #include <array>
+#include <string>
+#include <type_traits>
 #include <utility>
 
+#include "boost/assert.hpp"
+
+#include "Silicon/Archive.hpp"
 #include "Silicon/Renderer/Vertex.hpp"
 
 #include "Pipeline.hpp"
 
+namespace {
+
+template <typename T>
+void Append(std::string &bytes, const T &value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    bytes.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T>
+void AppendSpan(std::string &bytes, const T &values)
+{
+    Append(bytes, static_cast<std::uint64_t>(values.size()));
+    bytes.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(values[0]));
+}
+
+}
+
 namespace Si {
 
 template <>
@@ -54,14 +78,82 @@ std::array<vk::VertexInputAttributeDescription, 2> Vertex::getAttributeDescripti
     return {vertexPosition, vertexColor};
 }
 
+template <>
+vk::VertexInputBindingDescription InstanceData::getBindingDescription()
+{
+    return {1, sizeof(InstanceData), vk::VertexInputRate::eInstance};
+}
+
+template <>
+std::array<vk::VertexInputAttributeDescription, 2> InstanceData::getAttributeDescriptions()
+{
+    vk::VertexInputAttributeDescription instanceOffset {2, 1, vk::Format::eR32G32Sfloat, offsetof(InstanceData, offset)};
+    vk::VertexInputAttributeDescription instanceTint {3, 1, vk::Format::eR32G32B32Sfloat, offsetof(InstanceData, tint)};
+
+    return {instanceOffset, instanceTint};
+}
+
 namespace Vulkan {
 
+    bool PipelineDescription::Stage::operator==(const Stage &other) const
+    {
+        return type == other.type && spirv == other.spirv;
+    }
+
+    bool PipelineDescription::Blend::operator==(const Blend &other) const
+    {
+        return enable == other.enable && srcColorFactor == other.srcColorFactor && dstColorFactor == other.dstColorFactor && colorOp == other.colorOp
+            && srcAlphaFactor == other.srcAlphaFactor && dstAlphaFactor == other.dstAlphaFactor && alphaOp == other.alphaOp;
+    }
+
+    std::uint64_t PipelineDescription::hash() const
+    {
+        std::string bytes;
+
+        Append(bytes, reinterpret_cast<std::uintptr_t>(renderPass));
+
+        for (const Stage &stage : stages) {
+            Append(bytes, stage.type);
+            AppendSpan(bytes, stage.spirv);
+        }
+
+        // The Vulkan-Hpp wrappers are layout compatible with the C structs, which have no padding.
+        AppendSpan(bytes, bindings);
+        AppendSpan(bytes, attributes);
+
+        Append(bytes, topology);
+        Append(bytes, polygonMode);
+        Append(bytes, static_cast<VkCullModeFlags>(cullMode));
+        Append(bytes, frontFace);
+        Append(bytes, depthTest);
+        Append(bytes, depthWrite);
+        Append(bytes, depthCompareOp);
+        Append(bytes, blend.enable);
+        Append(bytes, blend.srcColorFactor);
+        Append(bytes, blend.dstColorFactor);
+        Append(bytes, blend.colorOp);
+        Append(bytes, blend.srcAlphaFactor);
+        Append(bytes, blend.dstAlphaFactor);
+        Append(bytes, blend.alphaOp);
+
+        return Archive::Hash(bytes);
+    }
+
+    bool PipelineDescription::operator==(const PipelineDescription &other) const
+    {
+        return renderPass == other.renderPass && stages == other.stages && bindings == other.bindings && attributes == other.attributes
+            && topology == other.topology && polygonMode == other.polygonMode && cullMode == other.cullMode && frontFace == other.frontFace
+            && depthTest == other.depthTest && depthWrite == other.depthWrite && depthCompareOp == other.depthCompareOp && blend == other.blend;
+    }
+
     Pipeline::Pipeline(RenderPass &renderPass, Vector<Shader> shaders)
         : m_renderPass(renderPass)
         , m_device(m_renderPass.getDevice())
-        , m_pipelineLayout(m_device)
         , m_shaders(std::move(shaders))
+        , m_pipelineLayout(m_device)
     {
+        m_description.renderPass = &m_renderPass;
+
         addDependency(m_pipelineLayout);
         addDependency(m_renderPass);
 
@@ -70,6 +162,26 @@ namespace Vulkan {
         }
     }
 
+    Pipeline::Pipeline(const PipelineDescription &description)
+        : m_renderPass(*description.renderPass)
+        , m_device(m_renderPass.getDevice())
+        , m_pipelineLayout(m_device)
+        , m_description(description)
+    {
+        BOOST_ASSERT_MSG(description.bindings.empty() == description.attributes.empty(), "A vertex layout needs both bindings and attributes");
+
+        addDependency(m_pipelineLayout);
+        addDependency(m_renderPass);
+
+        // The shaders point at each other through their dependencies, so they must never move once constructed.
+        m_shaders.reserve(m_description.stages.size());
+
+        for (const PipelineDescription::Stage &stage : m_description.stages) {
+            m_shaders.emplace_back(m_device, stage.spirv, stage.type);
+            addDependency(m_shaders.back());
+        }
+    }
+
     void Pipeline::setShaders(Vector<Shader> shaders)
     {
         for (Shader &shader : m_shaders) {
@@ -83,9 +195,19 @@ namespace Vulkan {
         }
     }
 
+    RenderPass &Pipeline::getRenderPass()
+    {
+        return m_renderPass;
+    }
+
+    const PipelineDescription &Pipeline::getDescription() const
+    {
+        return m_description;
+    }
+
     bool Pipeline::createImpl()
     {
-        Vector<vk::PipelineShaderStageCreateInfo> shaderStages;
+        ThreadLocalVector<vk::PipelineShaderStageCreateInfo> shaderStages;
         shaderStages.reserve(m_shaders.size());
 
         vk::ShaderStageFlagBits stage;
@@ -135,15 +257,26 @@ namespace Vulkan {
             shaderStages.push_back({{}, stage, *shader, "main"});
         }
 
-        std::array<vk::VertexInputBindingDescription, 1> vertexBindingDescriptions {Vertex::getBindingDescription<vk::VertexInputBindingDescription>()};
-        auto vertexAttributeDescriptions = Vertex::getAttributeDescriptions<vk::VertexInputAttributeDescription>();
+        ThreadLocalVector<vk::VertexInputBindingDescription> vertexBindingDescriptions(m_description.bindings.begin(), m_description.bindings.end());
+        ThreadLocalVector<vk::VertexInputAttributeDescription> vertexAttributeDescriptions(m_description.attributes.begin(), m_description.attributes.end());
+
+        if (vertexBindingDescriptions.empty()) {
+            vertexBindingDescriptions.push_back(Vertex::getBindingDescription<vk::VertexInputBindingDescription>());
+            vertexBindingDescriptions.push_back(InstanceData::getBindingDescription<vk::VertexInputBindingDescription>());
+
+            auto perVertexAttributes = Vertex::getAttributeDescriptions<vk::VertexInputAttributeDescription>();
+            auto perInstanceAttributes = InstanceData::getAttributeDescriptions<vk::VertexInputAttributeDescription>();
+
+            vertexAttributeDescriptions.insert(vertexAttributeDescriptions.end(), perVertexAttributes.begin(), perVertexAttributes.end());
+            vertexAttributeDescriptions.insert(vertexAttributeDescriptions.end(), perInstanceAttributes.begin(), perInstanceAttributes.end());
+        }
 
         vk::PipelineVertexInputStateCreateInfo vertexInputStateCreateInfo {
             {},
             vertexBindingDescriptions,
             vertexAttributeDescriptions};
 
-        vk::PipelineInputAssemblyStateCreateInfo inputAssemblyStateCreateInfo {{}, vk::PrimitiveTopology::eTriangleList, VK_FALSE};
+        vk::PipelineInputAssemblyStateCreateInfo inputAssemblyStateCreateInfo {{}, m_description.topology, VK_FALSE};
 
         vk::PipelineViewportStateCreateInfo viewportStateCreateInfo {{}, 1, nullptr, 1, nullptr};
 
@@ -151,9 +284,9 @@ namespace Vulkan {
             {},
             VK_FALSE,
             VK_FALSE,
-            vk::PolygonMode::eFill,
-            vk::CullModeFlagBits::eBack,
-            vk::FrontFace::eClockwise,
+            m_description.polygonMode,
+            m_description.cullMode,
+            m_description.frontFace,
             VK_FALSE,
             0,
             0,
@@ -162,14 +295,24 @@ namespace Vulkan {
 
         vk::PipelineMultisampleStateCreateInfo multisampleStateCreateInfo {{}, vk::SampleCountFlagBits::e1, VK_FALSE, 1};
 
+        vk::PipelineDepthStencilStateCreateInfo depthStencilStateCreateInfo {
+            {},
+            m_description.depthTest,
+            m_description.depthWrite,
+            m_description.depthCompareOp};
+
+        bool hasDepthState = m_description.depthTest || m_description.depthWrite;
+
+        const PipelineDescription::Blend &blend = m_description.blend;
+
         vk::PipelineColorBlendAttachmentState colorBlendAttachmentState {
-            VK_TRUE,
-            vk::BlendFactor::eSrcAlpha,
-            vk::BlendFactor::eOneMinusSrcAlpha,
-            vk::BlendOp::eAdd,
-            vk::BlendFactor::eOne,
-            vk::BlendFactor::eZero,
-            vk::BlendOp::eAdd,
+            blend.enable,
+            blend.srcColorFactor,
+            blend.dstColorFactor,
+            blend.colorOp,
+            blend.srcAlphaFactor,
+            blend.dstAlphaFactor,
+            blend.alphaOp,
             vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA};
 
         std::array<vk::PipelineColorBlendAttachmentState, 1> colorBlendAttachmentStates {colorBlendAttachmentState};
@@ -193,14 +336,28 @@ namespace Vulkan {
             &viewportStateCreateInfo,
             &rasterizationStateCreateInfo,
             &multisampleStateCreateInfo,
-            nullptr,
+            hasDepthState ? &depthStencilStateCreateInfo : nullptr,
             &colorBlendStateCreateInfo,
             &dynamicStateCreateInfo,
             *m_pipelineLayout,
             *m_renderPass,
             0};
 
-        m_handle = m_device->createGraphicsPipeline(VK_NULL_HANDLE, graphicsPipelineCreateInfo).value;
+        // With creation feedback the driver reports whether the pipeline came from the cache, which feeds the device's cache stats.
+        vk::PipelineCreationFeedbackEXT pipelineFeedback;
+        ThreadLocalVector<vk::PipelineCreationFeedbackEXT> stageFeedbacks(shaderStages.size());
+
+        vk::PipelineCreationFeedbackCreateInfoEXT feedbackCreateInfo;
+        feedbackCreateInfo.setPPipelineCreationFeedback(&pipelineFeedback);
+        feedbackCreateInfo.setPipelineStageCreationFeedbackCount(static_cast<std::uint32_t>(stageFeedbacks.size()));
+        feedbackCreateInfo.setPPipelineStageCreationFeedbacks(stageFeedbacks.data());
+
+        if (m_device.hasPipelineCreationFeedback()) {
+            graphicsPipelineCreateInfo.setPNext(&feedbackCreateInfo);
+        }
+
+        m_handle = m_device->createGraphicsPipeline(m_device.getPipelineCache(), graphicsPipelineCreateInfo).value;
+        m_device.recordPipelineCreation(m_device.hasPipelineCreationFeedback() ? &pipelineFeedback : nullptr);
 
         return true;
     }
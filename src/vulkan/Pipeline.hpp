@@ -43,6 +43,69 @@
 
 namespace Si::Vulkan {
 
+/**
+ * @brief Everything a graphics pipeline is built from, as plain data that can be hashed and compared.
+ *
+ * The defaults are the state every pipeline used before descriptions existed: a triangle list with back face culling and alpha
+ * blending, reading Vertex and InstanceData.
+ */
+struct PipelineDescription {
+    /**
+     * A compiled shader stage. Pipelines built from a description create their own shader modules from it.
+     */
+    struct Stage {
+        Shader::Type type;
+        Vector<std::uint32_t> spirv;
+
+        bool operator==(const Stage &other) const;
+    };
+
+    /**
+     * How the single color attachment is blended.
+     */
+    struct Blend {
+        bool enable = true;
+        vk::BlendFactor srcColorFactor = vk::BlendFactor::eSrcAlpha;
+        vk::BlendFactor dstColorFactor = vk::BlendFactor::eOneMinusSrcAlpha;
+        vk::BlendOp colorOp = vk::BlendOp::eAdd;
+        vk::BlendFactor srcAlphaFactor = vk::BlendFactor::eOne;
+        vk::BlendFactor dstAlphaFactor = vk::BlendFactor::eZero;
+        vk::BlendOp alphaOp = vk::BlendOp::eAdd;
+
+        bool operator==(const Blend &other) const;
+    };
+
+    /// The render pass the pipeline is used in. Compared by identity.
+    RenderPass *renderPass = nullptr;
+
+    Vector<Stage> stages;
+
+    /// The vertex layout. If both are empty, the layout of Vertex at binding 0 and InstanceData at binding 1 is used.
+    Vector<vk::VertexInputBindingDescription> bindings;
+    Vector<vk::VertexInputAttributeDescription> attributes;
+
+    vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+    vk::PolygonMode polygonMode = vk::PolygonMode::eFill;
+    vk::CullModeFlags cullMode = vk::CullModeFlagBits::eBack;
+    vk::FrontFace frontFace = vk::FrontFace::eClockwise;
+
+    /// Depth state only takes effect with a render pass that has a depth attachment.
+    bool depthTest = false;
+    bool depthWrite = false;
+    vk::CompareOp depthCompareOp = vk::CompareOp::eLess;
+
+    Blend blend;
+
+    /**
+     * Hashes every field, including the SPIR-V of each stage. This is not cheap, so hash a description once and keep the result.
+     *
+     * @return The hash of the description.
+     */
+    [[nodiscard]] std::uint64_t hash() const;
+
+    bool operator==(const PipelineDescription &other) const;
+};
+
 /**
  * Handle wrapper for Vulkan Pipeline
  */
@@ -50,8 +113,20 @@ class Pipeline : public Handle<vk::Pipeline>
 {
 public:
     explicit Pipeline(RenderPass &renderPass, Vector<Shader> shaders = {});
+
+    /**
+     * Creates a pipeline from a description, creating shader modules for its stages.
+     *
+     * @param description The description to build, which must have a render pass.
+     */
+    explicit Pipeline(const PipelineDescription &description);
+
     void setShaders(Vector<Shader> shaders);
 
+    RenderPass &getRenderPass();
+
+    [[nodiscard]] const PipelineDescription &getDescription() const;
+
 protected:
     bool createImpl() override;
     void destroyImpl() override;
@@ -63,6 +138,9 @@ private:
     Vector<Shader> m_shaders;
 
     PipelineLayout m_pipelineLayout;
+
+    // The stages are not used, m_shaders are, since they may have been set without a description.
+    PipelineDescription m_description;
 };
 
 }
@@ -0,0 +1,160 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/26/23.
+//
+
+#include <utility>
+
+#include "boost/assert.hpp"
+
+#include "Silicon/Async.hpp"
+#include "Silicon/Log.hpp"
+
+#include "PipelineBatch.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ToMilliseconds(std::chrono::nanoseconds time)
+{
+    return std::chrono::duration<double, std::milli>(time).count();
+}
+
+}
+
+namespace Si::Vulkan {
+
+PipelineBatch::PipelineBatch(Device &device)
+    : m_device(device)
+{
+}
+
+std::size_t PipelineBatch::addShader(std::string name, std::string source, Shader::Type type)
+{
+    m_shaders.push_back({std::move(name), std::move(source), type, {}});
+    return m_shaders.size() - 1;
+}
+
+void PipelineBatch::addPipeline(std::string name, Pipeline &pipeline, Vector<std::size_t> shaders)
+{
+    for (std::size_t shader : shaders) {
+        BOOST_ASSERT_MSG(shader < m_shaders.size(), "Pipeline refers to a shader that is not in the batch");
+    }
+
+    m_pipelines.push_back({std::move(name), &pipeline, std::move(shaders)});
+}
+
+PipelineBatch::Report PipelineBatch::build()
+{
+    Report report;
+    report.shaders.resize(m_shaders.size());
+    report.pipelines.resize(m_pipelines.size());
+
+    auto start = Clock::now();
+
+    if (!m_device.isCreated()) {
+        m_device.create();
+    }
+
+    tf::Taskflow taskflow;
+
+    tf::Task assign = taskflow.emplace([this]() {
+        for (PipelineItem &item : m_pipelines) {
+            // Shared dependencies are created here, so the pipeline tasks only ever create handles of their own.
+            RenderPass &renderPass = item.pipeline->getRenderPass();
+
+            if (!renderPass.isCreated()) {
+                renderPass.create();
+            }
+
+            if (item.shaders.empty()) {
+                continue;
+            }
+
+            Vector<Shader> shaders;
+            shaders.reserve(item.shaders.size());
+
+            for (std::size_t index : item.shaders) {
+                shaders.emplace_back(m_device, m_shaders[index].spirv, m_shaders[index].type);
+            }
+
+            item.pipeline->setShaders(std::move(shaders));
+        }
+    });
+
+    for (std::size_t i = 0; i < m_shaders.size(); i++) {
+        tf::Task compile = taskflow.emplace([this, &report, i]() {
+            ShaderItem &item = m_shaders[i];
+            bool cacheHit = false;
+
+            auto begin = Clock::now();
+            item.spirv = Shader::compile(item.source, item.type, &cacheHit);
+
+            report.shaders[i] = {item.name, Clock::now() - begin, cacheHit};
+        });
+
+        compile.precede(assign);
+    }
+
+    for (std::size_t i = 0; i < m_pipelines.size(); i++) {
+        tf::Task create = taskflow.emplace([this, &report, i]() {
+            PipelineItem &item = m_pipelines[i];
+
+            auto begin = Clock::now();
+            item.pipeline->create();
+
+            report.pipelines[i] = {item.name, Clock::now() - begin, false};
+        });
+
+        assign.precede(create);
+    }
+
+    GetAsyncExecutor().run(taskflow).wait();
+
+    report.total = Clock::now() - start;
+
+    for (const Timing &timing : report.shaders) {
+        Engine::Debug("Shader '{}' {} in {:.2f} ms", timing.name, timing.cacheHit ? "loaded from cache" : "compiled", ToMilliseconds(timing.time));
+    }
+
+    for (const Timing &timing : report.pipelines) {
+        Engine::Debug("Pipeline '{}' created in {:.2f} ms", timing.name, ToMilliseconds(timing.time));
+    }
+
+    Engine::Info("Built {} shaders and {} pipelines in {:.2f} ms", report.shaders.size(), report.pipelines.size(), ToMilliseconds(report.total));
+
+    m_shaders.clear();
+    m_pipelines.clear();
+
+    return report;
+}
+
+}
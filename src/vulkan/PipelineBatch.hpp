@@ -0,0 +1,127 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/26/23.
+//
+
+#ifndef YORK_VULKAN_PIPELINEBATCH_HPP
+#define YORK_VULKAN_PIPELINEBATCH_HPP
+
+#include <chrono>
+#include <string>
+
+#include "Silicon/Types.hpp"
+
+#include "Device.hpp"
+#include "Pipeline.hpp"
+#include "Shader.hpp"
+
+namespace Si::Vulkan {
+
+/**
+ * @brief Compiles a set of shaders and creates a set of pipelines concurrently on the async executor.
+ *
+ * Every shader is compiled to SPIR-V in its own task. Once they are all done a single task hands the shaders to all of their pipelines,
+ * one after another, since that edits the dependency lists handles share, and then every pipeline creates its shader modules and itself
+ * in its own task. Startup then takes about as long as the slowest shader and pipeline rather than all of them together.
+ */
+class PipelineBatch
+{
+public:
+    /**
+     * How long one shader or pipeline took.
+     */
+    struct Timing {
+        std::string name;
+        std::chrono::nanoseconds time;
+        bool cacheHit; ///< Whether a shader's SPIR-V came from the cache. Always false for pipelines.
+    };
+
+    /**
+     * The timing breakdown of a build.
+     */
+    struct Report {
+        Vector<Timing> shaders;
+        Vector<Timing> pipelines;
+        std::chrono::nanoseconds total; ///< Wall time of the whole build, which is less than the sum of the items when they overlap.
+    };
+
+    explicit PipelineBatch(Device &device);
+
+    /**
+     * Adds a GLSL shader to compile.
+     *
+     * @param name A name to report the shader's timing under.
+     * @param source The GLSL source.
+     * @param type The stage the shader is for.
+     * @return The index to refer to the shader by in addPipeline.
+     */
+    std::size_t addShader(std::string name, std::string source, Shader::Type type);
+
+    /**
+     * Adds a pipeline to create. It must outlive the call to build.
+     *
+     * @param name A name to report the pipeline's timing under.
+     * @param pipeline The pipeline to create.
+     * @param shaders The indices returned by addShader of the shaders to give the pipeline. If empty, the pipeline keeps its shaders.
+     */
+    void addPipeline(std::string name, Pipeline &pipeline, Vector<std::size_t> shaders = {});
+
+    /**
+     * @brief Compiles every shader and creates every pipeline, then clears the batch.
+     *
+     * Blocks until everything is built. Must not be called from a task on the async executor.
+     *
+     * @return How long each item took.
+     */
+    Report build();
+
+private:
+    struct ShaderItem {
+        std::string name;
+        std::string source;
+        Shader::Type type;
+        Vector<std::uint32_t> spirv;
+    };
+
+    struct PipelineItem {
+        std::string name;
+        NotNull<Pipeline *> pipeline;
+        Vector<std::size_t> shaders;
+    };
+
+    Device &m_device;
+
+    Vector<ShaderItem> m_shaders;
+    Vector<PipelineItem> m_pipelines;
+};
+
+}
+
+#endif // YORK_VULKAN_PIPELINEBATCH_HPP
@@ -0,0 +1,134 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/26/23.
+//
+
+#include "boost/assert.hpp"
+
+#include "PipelineCache.hpp"
+
+namespace Si::Vulkan {
+
+PipelineCache::Entry::Entry(const PipelineDescription &description)
+    : pipeline(description)
+{
+}
+
+PipelineCache::PipelineCache(Device &device)
+    : m_device(device)
+{
+}
+
+PipelineCache::~PipelineCache()
+{
+    waitForBuilds();
+
+    for (Entry &entry : m_entries) {
+        entry.pipeline.destroy();
+    }
+}
+
+PipelineCache::Id PipelineCache::request(const PipelineDescription &description)
+{
+    BOOST_ASSERT_MSG(description.renderPass, "A pipeline description needs a render pass");
+    BOOST_ASSERT_MSG(&description.renderPass->getDevice() == &m_device, "A pipeline description's render pass is on another device");
+
+    std::uint64_t hash = description.hash();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto [begin, end] = m_ids.equal_range(hash);
+
+    for (auto i = begin; i != end; i++) {
+        if (m_entries[i->second].pipeline.getDescription() == description) {
+            m_hits++;
+            return i->second;
+        }
+    }
+
+    m_misses++;
+
+    if (!description.renderPass->isCreated()) {
+        description.renderPass->create();
+    }
+
+    Id id = m_entries.size();
+    Entry &entry = m_entries.emplace_back(description);
+    m_ids.emplace(hash, id);
+
+    // The pipeline only creates handles of its own, its layout and shader modules, so it is safe to build off this thread.
+    entry.build = Async<void>([&entry]() {
+        entry.pipeline.create();
+    });
+
+    return id;
+}
+
+vk::Pipeline PipelineCache::get(Id id) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    BOOST_ASSERT_MSG(id < m_entries.size(), "Unknown pipeline id");
+
+    // Read the pipeline itself rather than a copy of its handle, which would go stale once the render pass is recreated. The
+    // handle is written before the pipeline is marked created, so it is complete once isCreated returns true.
+    const Pipeline &pipeline = m_entries[id].pipeline;
+    return pipeline.isCreated() ? pipeline.getHandle() : vk::Pipeline();
+}
+
+vk::Pipeline PipelineCache::wait(Id id)
+{
+    Entry *entry;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        BOOST_ASSERT_MSG(id < m_entries.size(), "Unknown pipeline id");
+
+        entry = &m_entries[id];
+    }
+
+    entry->build.wait();
+    return entry->pipeline.isCreated() ? entry->pipeline.getHandle() : vk::Pipeline();
+}
+
+void PipelineCache::waitForBuilds()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (Entry &entry : m_entries) {
+        entry.build.wait();
+    }
+}
+
+PipelineCache::Stats PipelineCache::getStats() const
+{
+    return {m_hits, m_misses};
+}
+
+}
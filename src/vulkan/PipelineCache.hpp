@@ -0,0 +1,139 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/26/23.
+//
+
+#ifndef YORK_VULKAN_PIPELINECACHE_HPP
+#define YORK_VULKAN_PIPELINECACHE_HPP
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include <vulkan/vulkan.hpp>
+
+#include "Silicon/Async.hpp"
+#include "Silicon/Types.hpp"
+
+#include "Device.hpp"
+#include "Pipeline.hpp"
+
+namespace Si::Vulkan {
+
+/**
+ * @brief Builds one pipeline per distinct PipelineDescription, and hands out the same pipeline for identical descriptions.
+ *
+ * Not to be confused with the driver's vk::PipelineCache, which Device owns and which makes building a pipeline cheaper. This one
+ * makes sure the same pipeline is never built twice.
+ *
+ * Descriptions are hashed once when requested, and the request returns an Id. Looking a pipeline up by Id at draw time is a single
+ * index. Missing pipelines are built on the async executor, so requesting one never blocks on the driver.
+ */
+class PipelineCache
+{
+public:
+    using Id = std::size_t;
+
+    struct Stats {
+        /// Requests that found a pipeline already built or building.
+        std::uint64_t hits;
+        /// Requests that started building a new pipeline.
+        std::uint64_t misses;
+    };
+
+    explicit PipelineCache(Device &device);
+
+    /**
+     * Waits for pipelines still building, then destroys every pipeline.
+     */
+    ~PipelineCache();
+
+    /**
+     * @brief Gets the Id of the pipeline for a description, starting to build it if no identical description was requested before.
+     *
+     * Safe to call from several threads at once. The description's render pass is created here if it is not yet, since the builds
+     * share it. A build reads the render pass's handle, so call waitForBuilds before recreating it.
+     *
+     * @param description The pipeline to get, which must have a render pass.
+     * @return The Id to look the pipeline up with.
+     */
+    Id request(const PipelineDescription &description);
+
+    /**
+     * Gets a pipeline if it has finished building. Pipelines recreated along with their render pass are picked up here.
+     *
+     * @param id An Id returned by request.
+     * @return The pipeline, or a null handle while it is still building.
+     */
+    [[nodiscard]] vk::Pipeline get(Id id) const;
+
+    /**
+     * Gets a pipeline, waiting for it to finish building if needed. Must not be called from a task on the async executor.
+     *
+     * @param id An Id returned by request.
+     * @return The pipeline.
+     */
+    vk::Pipeline wait(Id id);
+
+    /**
+     * Waits for every pipeline still building. Must not be called from a task on the async executor.
+     *
+     * Call this before recreating a render pass pipelines were requested with. A pipeline depends on its render pass from the moment
+     * it is constructed, but recreating the render pass only recreates dependents that are already created, so a pipeline still
+     * building would be skipped and finish with the old render pass.
+     */
+    void waitForBuilds();
+
+    [[nodiscard]] Stats getStats() const;
+
+private:
+    struct Entry {
+        explicit Entry(const PipelineDescription &description);
+
+        Pipeline pipeline;
+        Future<void> build;
+    };
+
+    Device &m_device;
+
+    mutable std::mutex m_mutex;
+
+    // A deque, since handles point at each other and must never move once constructed.
+    std::deque<Entry> m_entries;
+    std::unordered_multimap<std::uint64_t, Id> m_ids;
+
+    std::atomic<std::uint64_t> m_hits {0};
+    std::atomic<std::uint64_t> m_misses {0};
+};
+
+}
+
+#endif // YORK_VULKAN_PIPELINECACHE_HPP
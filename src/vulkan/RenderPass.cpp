@@ -40,18 +40,26 @@ RenderPass::RenderPass(Device &device)
     addDependency(m_device);
 }
 
+RenderPass::RenderPass(Device &device, vk::Format format, vk::ImageLayout finalLayout)
+    : m_device(device)
+    , m_format(format)
+    , m_finalLayout(finalLayout)
+{
+    addDependency(m_device);
+}
+
 bool RenderPass::createImpl()
 {
     vk::AttachmentDescription attachmentDescription {
         {},
-        m_device.getPhysicalDevice().getBestFormat().format,
+        m_format == vk::Format::eUndefined ? m_device.getPhysicalDevice().getBestFormat().format : m_format,
         vk::SampleCountFlagBits::e1,
         vk::AttachmentLoadOp::eClear,
         vk::AttachmentStoreOp::eStore,
         vk::AttachmentLoadOp::eDontCare,
         vk::AttachmentStoreOp::eDontCare,
         vk::ImageLayout::eUndefined,
-        vk::ImageLayout::ePresentSrcKHR};
+        m_finalLayout};
 
     vk::AttachmentReference attachmentReference {
         0,
@@ -76,7 +84,16 @@ bool RenderPass::createImpl()
         vk::AccessFlagBits::eNoneKHR,
         vk::AccessFlagBits::eColorAttachmentWrite};
 
-    std::array<vk::SubpassDependency, 1> dependencies {dependency};
+    // Copies out of the attachment have to wait for the render pass to finish writing it.
+    vk::SubpassDependency transferDependency {
+        0,
+        VK_SUBPASS_EXTERNAL,
+        vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        vk::PipelineStageFlagBits::eTransfer,
+        vk::AccessFlagBits::eColorAttachmentWrite,
+        vk::AccessFlagBits::eTransferRead};
+
+    std::array<vk::SubpassDependency, 2> dependencies {dependency, transferDependency};
 
     vk::RenderPassCreateInfo renderPassCreateInfo {
         {},
@@ -84,6 +101,10 @@ bool RenderPass::createImpl()
         subpassDescription,
         dependencies};
 
+    if (m_finalLayout != vk::ImageLayout::eTransferSrcOptimal) {
+        renderPassCreateInfo.dependencyCount = 1;
+    }
+
     m_handle = m_device->createRenderPass(renderPassCreateInfo);
 
     return true;
@@ -46,7 +46,22 @@ namespace Si::Vulkan {
 class RenderPass : public Handle<vk::RenderPass>
 {
 public:
+    /**
+     * Creates a render pass that draws to the swap chain, in the surface's best format.
+     *
+     * @param device The device to create the render pass on.
+     */
     explicit RenderPass(Device &device);
+
+    /**
+     * Creates a render pass that draws to an image of the given format and leaves it in finalLayout.
+     *
+     * @param device The device to create the render pass on.
+     * @param format The format of the color attachment.
+     * @param finalLayout The layout the attachment is left in, for example eTransferSrcOptimal to copy it out afterwards.
+     */
+    RenderPass(Device &device, vk::Format format, vk::ImageLayout finalLayout);
+
     Device &getDevice();
 
 protected:
@@ -55,6 +70,9 @@ protected:
 
 private:
     Device &m_device;
+
+    vk::Format m_format = vk::Format::eUndefined;
+    vk::ImageLayout m_finalLayout = vk::ImageLayout::ePresentSrcKHR;
 };
 
 }
@@ -0,0 +1,146 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/25/23.
+//
+
+#include <algorithm>
+#include <array>
+
+#include "Silicon/Async.hpp"
+
+#include "SceneRecorder.hpp"
+
+namespace {
+
+struct GeometryHandles {
+    vk::Buffer vertices;
+    vk::Buffer indices;
+    vk::Buffer instances;
+};
+
+void RecordDraws(vk::CommandBuffer commandBuffer, vk::Extent2D extent, vk::Pipeline pipeline, const GeometryHandles &geometry, Si::Span<const Si::Renderer::DrawCommand> draws)
+{
+    vk::Viewport viewport {
+        0,
+        0,
+        static_cast<float>(extent.width),
+        static_cast<float>(extent.height),
+        0,
+        1};
+
+    vk::Rect2D scissor {{0, 0}, extent};
+
+    commandBuffer.setViewport(0, {viewport});
+    commandBuffer.setScissor(0, {scissor});
+
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+
+    std::array<vk::Buffer, 2> vertexBuffers {geometry.vertices, geometry.instances};
+    std::array<vk::DeviceSize, 2> vertexOffsets {0, 0};
+
+    commandBuffer.bindVertexBuffers(0, vertexBuffers, vertexOffsets);
+    commandBuffer.bindIndexBuffer(geometry.indices, 0, vk::IndexType::eUint32);
+
+    for (const Si::Renderer::DrawCommand &draw : draws) {
+        if (draw.indexCount) {
+            commandBuffer.drawIndexed(draw.indexCount, draw.instanceCount, draw.firstIndex, static_cast<std::int32_t>(draw.firstVertex), draw.firstInstance);
+        } else {
+            commandBuffer.draw(draw.vertexCount, draw.instanceCount, draw.firstVertex, draw.firstInstance);
+        }
+    }
+}
+
+}
+
+namespace Si::Vulkan {
+
+SceneRecorder::SceneRecorder(Device &device, std::uint32_t framesInFlight)
+    : m_workerCount(std::max<std::uint32_t>(GetAsyncExecutor().num_workers(), 1))
+{
+    // The pools point at the device, so they must never move once constructed.
+    m_pools.reserve(framesInFlight * m_workerCount);
+    m_secondaryBuffers.reserve(framesInFlight * m_workerCount);
+
+    for (std::uint32_t i = 0; i < framesInFlight * m_workerCount; i++) {
+        m_pools.emplace_back(device);
+
+        vk::CommandBufferAllocateInfo allocateInfo {*m_pools.back(), vk::CommandBufferLevel::eSecondary, 1};
+        m_secondaryBuffers.push_back(device->allocateCommandBuffers<Allocator<vk::CommandBuffer>>(allocateInfo).front());
+    }
+}
+
+void SceneRecorder::record(vk::CommandBuffer primary, std::uint32_t frameIndex, RenderPass &renderPass, Framebuffer &framebuffer, vk::Extent2D extent, vk::Pipeline pipeline, const Geometry &geometry, Span<const Renderer::DrawCommand> draws)
+{
+    std::size_t sliceCount = std::min<std::size_t>(m_workerCount, draws.size() / MinDrawsPerWorker);
+
+    // Resolve the handles here, since dereferencing one that is not created yet would create it, which is not safe from the workers.
+    vk::RenderPass renderPassHandle = *renderPass;
+    vk::Framebuffer framebufferHandle = *framebuffer;
+    GeometryHandles geometryHandles {*geometry.vertices, *geometry.indices, *geometry.instances};
+
+    vk::ClearValue clearValue {vk::ClearColorValue().setFloat32({0, 0, 0, 0})};
+    vk::RenderPassBeginInfo renderPassBeginInfo {renderPassHandle, framebufferHandle, {{0, 0}, extent}, clearValue};
+
+    if (sliceCount < 2) {
+        primary.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
+        RecordDraws(primary, extent, pipeline, geometryHandles, draws);
+        primary.endRenderPass();
+        return;
+    }
+
+    Span<vk::CommandBuffer> secondaryBuffers(m_secondaryBuffers.data() + frameIndex * m_workerCount, sliceCount);
+    vk::CommandBufferInheritanceInfo inheritanceInfo {renderPassHandle, 0, framebufferHandle};
+
+    tf::Taskflow taskflow;
+
+    for (std::size_t i = 0; i < sliceCount; i++) {
+        std::size_t begin = draws.size() * i / sliceCount;
+        std::size_t end = draws.size() * (i + 1) / sliceCount;
+
+        taskflow.emplace([&, i, begin, end]() {
+            vk::CommandBuffer commandBuffer = secondaryBuffers[i];
+
+            vk::CommandBufferBeginInfo beginInfo {vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue, &inheritanceInfo};
+            commandBuffer.begin(beginInfo);
+
+            RecordDraws(commandBuffer, extent, pipeline, geometryHandles, draws.subspan(begin, end - begin));
+
+            commandBuffer.end();
+        });
+    }
+
+    GetAsyncExecutor().run(taskflow).wait();
+
+    primary.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eSecondaryCommandBuffers);
+    primary.executeCommands(vk::ArrayProxy<const vk::CommandBuffer>(static_cast<std::uint32_t>(secondaryBuffers.size()), secondaryBuffers.data()));
+    primary.endRenderPass();
+}
+
+}
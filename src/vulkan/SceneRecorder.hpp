@@ -0,0 +1,102 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/25/23.
+//
+
+#ifndef YORK_VULKAN_SCENERECORDER_HPP
+#define YORK_VULKAN_SCENERECORDER_HPP
+
+#include <vulkan/vulkan.hpp>
+
+#include "Silicon/Renderer/Renderer.hpp"
+#include "Silicon/Types.hpp"
+
+#include "Buffer.hpp"
+#include "CommandPool.hpp"
+#include "Framebuffer.hpp"
+#include "Pipeline.hpp"
+
+namespace Si::Vulkan {
+
+/**
+ * @brief Records a frame's render pass, splitting long draw lists across the async executor's workers.
+ *
+ * Every worker gets its own CommandPool and secondary command buffer for each frame in flight, since a pool may only be used by one
+ * thread at a time. Each task records a contiguous slice of the draws, and the primary command buffer runs the slices in order with
+ * executeCommands. Short draw lists are recorded inline, where spawning tasks would cost more than it saves.
+ */
+class SceneRecorder
+{
+public:
+    /**
+     * Below this many draws per worker, a slice is not worth a task of its own.
+     */
+    static constexpr std::size_t MinDrawsPerWorker = 64;
+
+    /**
+     * The buffers a scene's draws read from.
+     */
+    struct Geometry {
+        Buffer &vertices; ///< Bound to binding 0, see Vertex::getBindingDescription.
+        Buffer &indices; ///< 32 bit indices for indexed draws.
+        Buffer &instances; ///< Bound to binding 1, see InstanceData::getBindingDescription.
+    };
+
+    /**
+     * @param device The device to create the command pools on.
+     * @param framesInFlight How many frames may be recording or rendering at once, each needing its own secondary command buffers.
+     */
+    SceneRecorder(Device &device, std::uint32_t framesInFlight);
+
+    /**
+     * @brief Records the render pass with all the draws into a primary command buffer that has already begun.
+     *
+     * @param primary The command buffer to record into.
+     * @param frameIndex The frame in flight being recorded, whose GPU work must have finished.
+     * @param renderPass The render pass to begin.
+     * @param framebuffer The framebuffer to render to.
+     * @param extent The size of the framebuffer.
+     * @param pipeline The pipeline to draw with, which must be built.
+     * @param geometry The buffers the draws read from.
+     * @param draws The draws to record, in order.
+     */
+    void record(vk::CommandBuffer primary, std::uint32_t frameIndex, RenderPass &renderPass, Framebuffer &framebuffer, vk::Extent2D extent, vk::Pipeline pipeline, const Geometry &geometry, Span<const Renderer::DrawCommand> draws);
+
+private:
+    std::uint32_t m_workerCount;
+
+    // Indexed by frameIndex * m_workerCount + worker.
+    Vector<CommandPool> m_pools;
+    Vector<vk::CommandBuffer> m_secondaryBuffers;
+};
+
+}
+
+#endif // YORK_VULKAN_SCENERECORDER_HPP
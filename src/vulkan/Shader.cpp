@@ -28,46 +28,233 @@
 // Created by Matthew McCall on 11/21/22.
 //
 
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+#include "boost/assert.hpp"
 #include "shaderc/shaderc.hpp"
+#include "spdlog/fmt/fmt.h"
 #include "vulkan/vulkan.hpp"
 
+#include "Silicon/Archive.hpp"
+#include "Silicon/Config.hpp"
 #include "Silicon/Log.hpp"
 #include "Silicon/Types.hpp"
 
 #include "Shader.hpp"
+#include "TemporaryPath.hpp"
 
-namespace Si::Vulkan {
+namespace {
 
-Shader::Shader(Device &device, const std::string &string, Type type)
-    : Si::Shader(string, type)
-    , m_device(&device)
-    , m_string(string)
-{
-    addDependency(*m_device);
+using Clock = std::chrono::steady_clock;
 
-    shaderc::Compiler compiler;
-    shaderc::CompilationResult<std::uint32_t> result;
+constexpr std::uint32_t CacheMagic = 0x50535349; // "ISSP"
+constexpr std::uint32_t CacheVersion = 2;
+constexpr std::uint32_t SpirvMagic = 0x07230203;
+
+/**
+ * Everything a cached module was compiled from. A cache file is only used if its header matches the one a compile would produce.
+ */
+struct CacheHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t sourceHash;
+    std::uint64_t sourceSize;
+    std::uint32_t kind;
+    std::uint32_t optimizationLevel;
+    std::uint32_t debugInfo;
+    std::uint32_t spirvVersion;
+    std::uint64_t compilerVersion;
+    std::uint64_t spirvWords;
+};
+
+std::mutex s_cacheDirectoryMutex;
+std::string s_cacheDirectory = "ShaderCache";
 
-    shaderc_shader_kind kind;
+std::atomic<std::uint64_t> s_hits {0};
+std::atomic<std::uint64_t> s_misses {0};
+std::atomic<std::int64_t> s_compileNanoseconds {0};
 
-    switch (m_type) {
-    case Type::Vertex:
-        kind = shaderc_shader_kind::shaderc_glsl_vertex_shader;
-        break;
+bool Matches(const CacheHeader &a, const CacheHeader &b)
+{
+    return std::memcmp(&a, &b, offsetof(CacheHeader, spirvWords)) == 0;
+}
+
+shaderc_shader_kind GetShaderKind(Si::Shader::Type type)
+{
+    switch (type) {
+    case Si::Shader::Type::Vertex:
+        return shaderc_shader_kind::shaderc_glsl_vertex_shader;
 
-    case Type::Fragment:
-        kind = shaderc_shader_kind::shaderc_glsl_fragment_shader;
-        break;
+    case Si::Shader::Type::Fragment:
+        return shaderc_shader_kind::shaderc_glsl_fragment_shader;
 
     default:
-        kind = shaderc_shader_kind::shaderc_glsl_infer_from_source;
-        break;
+        return shaderc_shader_kind::shaderc_glsl_infer_from_source;
+    }
+}
+
+std::string GetCacheDirectory()
+{
+    std::lock_guard<std::mutex> lock(s_cacheDirectoryMutex);
+    return s_cacheDirectory;
+}
+
+bool ReadCache(const std::filesystem::path &path, const CacheHeader &expected, Si::Vector<std::uint32_t> &spirv)
+{
+    std::ifstream file(path, std::ios::binary);
+    CacheHeader header {};
+
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || !Matches(header, expected) || !header.spirvWords) {
+        return false;
+    }
+
+    spirv.resize(header.spirvWords);
+
+    if (!file.read(reinterpret_cast<char *>(spirv.data()), static_cast<std::streamsize>(spirv.size() * sizeof(std::uint32_t))) || spirv.front() != SpirvMagic) {
+        spirv.clear();
+        return false;
+    }
+
+    return true;
+}
+
+void WriteCache(const std::filesystem::path &path, CacheHeader header, const Si::Vector<std::uint32_t> &spirv)
+{
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    // Written under a temporary name and renamed into place, so another process never reads a half written file.
+    std::filesystem::path temporary = Si::Vulkan::GetTemporaryPath(path);
+
+    header.spirvWords = spirv.size();
+
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(spirv.data()), static_cast<std::streamsize>(spirv.size() * sizeof(std::uint32_t)));
+
+        if (!file) {
+            Si::Engine::Warn("Failed to write shader cache file '{}'", temporary.string());
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(temporary, path, error);
+
+    if (error) {
+        Si::Engine::Warn("Failed to write shader cache file '{}': {}", path.string(), error.message());
+        std::filesystem::remove(temporary, error);
     }
+}
+
+Si::Vector<std::uint32_t> Compile(const std::string &source, Si::Shader::Type type, bool *cacheHit)
+{
+    shaderc_shader_kind kind = GetShaderKind(type);
+
+    shaderc::CompileOptions options;
+    CacheHeader header {CacheMagic, CacheVersion, Si::Archive::Hash(source), source.size(), static_cast<std::uint32_t>(kind)};
+
+    if constexpr (SI_BUILD_CONFIG == Si::BuildConfig::Debug) {
+        options.SetOptimizationLevel(shaderc_optimization_level_zero);
+        options.SetGenerateDebugInfo();
 
-    result = compiler.CompileGlslToSpv(m_string, kind, "");
+        header.optimizationLevel = shaderc_optimization_level_zero;
+        header.debugInfo = 1;
+    } else {
+        options.SetOptimizationLevel(shaderc_optimization_level_performance);
+        header.optimizationLevel = shaderc_optimization_level_performance;
+    }
+
+    unsigned int spirvVersion = 0;
+    unsigned int spirvRevision = 0;
+    shaderc_get_spv_version(&spirvVersion, &spirvRevision);
+    header.spirvVersion = spirvVersion;
+
+    // shaderc can not report its own version, but it ships with the Vulkan SDK, whose headers it was built against.
+    header.compilerVersion = VK_HEADER_VERSION_COMPLETE;
+
+    Si::Vector<std::uint32_t> spirv;
+
+    std::string directory = GetCacheDirectory();
+    std::filesystem::path path;
+
+    if (!directory.empty()) {
+        std::uint64_t key = Si::Archive::Hash(std::string_view(reinterpret_cast<const char *>(&header), sizeof(header)));
+        path = std::filesystem::path(directory) / fmt::format("{:016x}.spv", key);
+
+        if (ReadCache(path, header, spirv)) {
+            s_hits++;
+
+            if (cacheHit) {
+                *cacheHit = true;
+            }
+
+            Si::Engine::Trace("Loaded shader {:016x} from the SPIR-V cache", header.sourceHash);
+            return spirv;
+        }
+    }
+
+    auto start = Clock::now();
+
+    shaderc::Compiler compiler;
+    shaderc::CompilationResult<std::uint32_t> result = compiler.CompileGlslToSpv(source, kind, "", options);
     BOOST_ASSERT_MSG(result.GetCompilationStatus() == shaderc_compilation_status_success, result.GetErrorMessage().c_str());
 
-    m_spirv.insert(m_spirv.end(), result.cbegin(), result.cend());
+    auto compileTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+
+    s_misses++;
+
+    if (cacheHit) {
+        *cacheHit = false;
+    }
+
+    s_compileNanoseconds += compileTime.count();
+
+    Si::Engine::Debug("Compiled shader {:016x} in {:.2f} ms", header.sourceHash, compileTime.count() / 1e6);
+
+    spirv.insert(spirv.end(), result.cbegin(), result.cend());
+
+    if (!path.empty()) {
+        WriteCache(path, header, spirv);
+    }
+
+    return spirv;
+}
+
+}
+
+namespace Si::Vulkan {
+
+Shader::Shader(Device &device, const std::string &string, Type type)
+    : Si::Shader(string, type)
+    , m_device(&device)
+    , m_spirv(Compile(string, type, nullptr))
+    , m_string(string)
+{
+    addDependency(*m_device);
+}
+
+void Shader::setCacheDirectory(const std::string &directory)
+{
+    std::lock_guard<std::mutex> lock(s_cacheDirectoryMutex);
+    s_cacheDirectory = directory;
+}
+
+Vector<std::uint32_t> Shader::compile(const std::string &string, Type type, bool *cacheHit)
+{
+    return Compile(string, type, cacheHit);
+}
+
+Shader::CacheStats Shader::getCacheStats()
+{
+    return {s_hits, s_misses, std::chrono::nanoseconds(s_compileNanoseconds.load())};
 }
 
 bool Shader::createImpl()
@@ -84,9 +271,9 @@ void Shader::destroyImpl()
 Shader::Shader(Device &device, const Vector<uint32_t> &spirv, Shader::Type type)
     : Si::Shader(spirv, type)
     , m_device(&device)
+    , m_spirv(spirv)
 {
     addDependency(device);
-    m_device = &device;
 }
 
 } // Si::Vulkan
\ No newline at end of file
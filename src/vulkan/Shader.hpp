@@ -31,6 +31,8 @@
 #ifndef SILICON_VULKANRENDERER_SHADER_HPP
 #define SILICON_VULKANRENDERER_SHADER_HPP
 
+#include <chrono>
+
 #include "Silicon/Shader.hpp"
 
 #include "Device.hpp"
@@ -40,9 +42,46 @@ namespace Si::Vulkan {
 class Shader : public Si::Shader, public Handle<vk::ShaderModule>
 {
 public:
+    struct CacheStats {
+        /// Shaders loaded from the SPIR-V cache without running the compiler.
+        std::uint64_t hits;
+        /// Shaders that had to be compiled, and were then added to the cache.
+        std::uint64_t misses;
+        /// Time spent in the compiler on misses.
+        std::chrono::nanoseconds compileTime;
+    };
+
     Shader(Device &device, const Vector<std::uint32_t> &spirv, Type type);
+
+    /**
+     * Compiles a GLSL shader, or loads it from the SPIR-V cache if the same source was compiled the same way before.
+     *
+     * @param device The device to create the shader module on.
+     * @param string The GLSL source.
+     * @param type The stage the shader is for.
+     */
     Shader(Device &device, const std::string &string, Type type);
 
+    /**
+     * Sets the directory compiled SPIR-V is cached in, which is created if needed. The cache is keyed by a hash of the source, the
+     * shader kind and the compile options, so it never has to be cleared by hand. Defaults to "ShaderCache" in the working directory.
+     *
+     * @param directory The directory to cache in, or an empty string to always compile.
+     */
+    static void setCacheDirectory(const std::string &directory);
+
+    static CacheStats getCacheStats();
+
+    /**
+     * Compiles GLSL to SPIR-V through the cache without creating a shader module. Safe to call from several threads at once.
+     *
+     * @param string The GLSL source.
+     * @param type The stage the shader is for.
+     * @param cacheHit Set to whether the SPIR-V came from the cache, if not null.
+     * @return The SPIR-V.
+     */
+    static Vector<std::uint32_t> compile(const std::string &string, Type type, bool *cacheHit = nullptr);
+
 protected:
     bool createImpl() override;
     void destroyImpl() override;
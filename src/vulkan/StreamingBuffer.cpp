@@ -0,0 +1,317 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/25/23.
+//
+
+#include <algorithm>
+#include <utility>
+
+#include "StreamingBuffer.hpp"
+
+namespace {
+
+// Staged uploads start on this boundary, which keeps the copies on the fast path of most drivers.
+constexpr std::size_t StagingAlignment = 16;
+
+/**
+ * Gets the stages and accesses that read a buffer with the given usage, which uploads into it have to be ordered against.
+ */
+std::pair<vk::PipelineStageFlags, vk::AccessFlags> GetReaders(vk::BufferUsageFlags usage)
+{
+    vk::PipelineStageFlags stages;
+    vk::AccessFlags access;
+
+    if (usage & vk::BufferUsageFlagBits::eVertexBuffer) {
+        stages |= vk::PipelineStageFlagBits::eVertexInput;
+        access |= vk::AccessFlagBits::eVertexAttributeRead;
+    }
+
+    if (usage & vk::BufferUsageFlagBits::eIndexBuffer) {
+        stages |= vk::PipelineStageFlagBits::eVertexInput;
+        access |= vk::AccessFlagBits::eIndexRead;
+    }
+
+    if (usage & vk::BufferUsageFlagBits::eUniformBuffer) {
+        stages |= vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader;
+        access |= vk::AccessFlagBits::eUniformRead;
+    }
+
+    if (usage & vk::BufferUsageFlagBits::eStorageBuffer) {
+        stages |= vk::PipelineStageFlagBits::eVertexShader | vk::PipelineStageFlagBits::eFragmentShader | vk::PipelineStageFlagBits::eComputeShader;
+        access |= vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite;
+    }
+
+    if (!stages) {
+        stages = vk::PipelineStageFlagBits::eAllCommands;
+        access = vk::AccessFlagBits::eMemoryRead;
+    }
+
+    return {stages, access};
+}
+
+}
+
+namespace Si::Vulkan {
+
+StagingRing::StagingRing(Instance &instance, Device &device, std::uint32_t framesInFlight, std::size_t frameCapacity)
+    : m_instance(instance)
+    , m_device(device)
+    , m_frames(framesInFlight)
+{
+    for (Frame &frame : m_frames) {
+        frame.buffers.push_back(createBuffer(frameCapacity));
+    }
+}
+
+StagingRing::~StagingRing()
+{
+    for (Frame &frame : m_frames) {
+        for (std::unique_ptr<Buffer> &buffer : frame.buffers) {
+            buffer->destroy();
+        }
+    }
+}
+
+void StagingRing::beginFrame(std::uint32_t frameIndex)
+{
+    m_frameIndex = frameIndex;
+    m_frameNumber++;
+
+    Frame &frame = m_frames[m_frameIndex];
+    frame.offset = 0;
+
+    if (frame.buffers.size() == 1) {
+        return;
+    }
+
+    // The frame outgrew its buffer last time, so give it one buffer big enough for all of it.
+    std::size_t capacity = 0;
+
+    for (std::unique_ptr<Buffer> &buffer : frame.buffers) {
+        capacity += buffer->getSize();
+        buffer->destroy();
+    }
+
+    frame.buffers.clear();
+    frame.buffers.push_back(createBuffer(capacity));
+}
+
+StagingRing::Allocation StagingRing::stage(Span<const std::uint8_t> bytes)
+{
+    Frame &frame = m_frames[m_frameIndex];
+    std::size_t offset = (frame.offset + StagingAlignment - 1) & ~(StagingAlignment - 1);
+
+    if (offset + bytes.size() > frame.buffers.back()->getSize()) {
+        frame.buffers.push_back(createBuffer(std::max(frame.buffers.back()->getSize() * 2, bytes.size())));
+        offset = 0;
+    }
+
+    Buffer &buffer = *frame.buffers.back();
+    buffer.copyData(bytes, offset);
+    frame.offset = offset + bytes.size();
+
+    return {&buffer, offset};
+}
+
+Instance &StagingRing::getInstance() const
+{
+    return m_instance;
+}
+
+Device &StagingRing::getDevice() const
+{
+    return m_device;
+}
+
+std::uint32_t StagingRing::getFrameIndex() const
+{
+    return m_frameIndex;
+}
+
+std::uint32_t StagingRing::getFrameCount() const
+{
+    return static_cast<std::uint32_t>(m_frames.size());
+}
+
+std::uint64_t StagingRing::getFrameNumber() const
+{
+    return m_frameNumber;
+}
+
+std::unique_ptr<Buffer> StagingRing::createBuffer(std::size_t size)
+{
+    auto buffer = std::make_unique<Buffer>(m_instance, m_device, size, vk::BufferUsageFlagBits::eTransferSrc, Buffer::HostAccess::SequentialWrite);
+    buffer->create();
+
+    return buffer;
+}
+
+StreamingBuffer::StreamingBuffer(StagingRing &staging, vk::BufferUsageFlags usage, std::size_t capacity)
+    : m_staging(staging)
+    , m_usage(usage | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc)
+    , m_buffer(std::make_unique<Buffer>(staging.getInstance(), staging.getDevice(), capacity, m_usage, Buffer::HostAccess::None))
+    , m_retired(staging.getFrameCount())
+{
+    m_buffer->create();
+}
+
+StreamingBuffer::~StreamingBuffer()
+{
+    for (Vector<std::unique_ptr<Buffer>> &retired : m_retired) {
+        for (std::unique_ptr<Buffer> &buffer : retired) {
+            buffer->destroy();
+        }
+    }
+
+    m_buffer->destroy();
+}
+
+void StreamingBuffer::write(Span<const std::uint8_t> bytes, std::size_t offset)
+{
+    if (bytes.empty()) {
+        return;
+    }
+
+    releaseRetired();
+    reserve(offset + bytes.size());
+
+    StagingRing::Allocation allocation = m_staging.stage(bytes);
+    m_pending.push_back({**allocation.buffer, {allocation.offset, offset, bytes.size()}});
+}
+
+void StreamingBuffer::flush(vk::CommandBuffer commandBuffer)
+{
+    releaseRetired();
+
+    if (m_pending.empty() && !m_growSource) {
+        return;
+    }
+
+    auto [readStages, readAccess] = GetReaders(m_usage);
+    vk::Buffer destination = **m_buffer;
+
+    // Earlier frames may still be reading the ranges about to be overwritten. Write-after-read only needs the execution dependency.
+    commandBuffer.pipelineBarrier(readStages, vk::PipelineStageFlagBits::eTransfer, {}, {}, {}, {});
+
+    if (m_growSource) {
+        // The old buffer's contents were last written by a transfer in an earlier flush, whose barrier only made them visible to the
+        // readers of the buffer, not to the transfer that now copies them.
+        vk::BufferMemoryBarrier sourceBarrier {
+            vk::AccessFlagBits::eTransferWrite,
+            vk::AccessFlagBits::eTransferRead,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            m_growSource,
+            0,
+            VK_WHOLE_SIZE};
+
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {}, {}, {sourceBarrier}, {});
+
+        commandBuffer.copyBuffer(m_growSource, destination, {vk::BufferCopy {0, 0, m_growSize}});
+
+        vk::BufferMemoryBarrier growBarrier {
+            vk::AccessFlagBits::eTransferWrite,
+            vk::AccessFlagBits::eTransferWrite,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            destination,
+            0,
+            VK_WHOLE_SIZE};
+
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer, {}, {}, {growBarrier}, {});
+
+        m_growSource = nullptr;
+        m_growSize = 0;
+    }
+
+    for (const Copy &copy : m_pending) {
+        commandBuffer.copyBuffer(copy.source, destination, {copy.region});
+    }
+
+    m_pending.clear();
+
+    vk::BufferMemoryBarrier uploadBarrier {
+        vk::AccessFlagBits::eTransferWrite,
+        readAccess,
+        VK_QUEUE_FAMILY_IGNORED,
+        VK_QUEUE_FAMILY_IGNORED,
+        destination,
+        0,
+        VK_WHOLE_SIZE};
+
+    commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, readStages, {}, {}, {uploadBarrier}, {});
+}
+
+Buffer &StreamingBuffer::getBuffer()
+{
+    return *m_buffer;
+}
+
+std::size_t StreamingBuffer::getCapacity() const
+{
+    return m_buffer->getSize();
+}
+
+void StreamingBuffer::reserve(std::size_t size)
+{
+    if (size <= m_buffer->getSize()) {
+        return;
+    }
+
+    // Only what the buffer held at the start of the frame is copied, even if it grows twice. Writes since then are still pending.
+    if (!m_growSource) {
+        m_growSource = **m_buffer;
+        m_growSize = m_buffer->getSize();
+    }
+
+    auto buffer = std::make_unique<Buffer>(m_staging.getInstance(), m_staging.getDevice(), std::max(m_buffer->getSize() * 2, size), m_usage, Buffer::HostAccess::None);
+    buffer->create();
+
+    m_retired[m_staging.getFrameIndex()].push_back(std::move(m_buffer));
+    m_buffer = std::move(buffer);
+}
+
+void StreamingBuffer::releaseRetired()
+{
+    if (m_frameNumber == m_staging.getFrameNumber()) {
+        return;
+    }
+
+    m_frameNumber = m_staging.getFrameNumber();
+
+    // The renderer has waited for the last frame that used this slot, so nothing reads these any more.
+    for (std::unique_ptr<Buffer> &buffer : m_retired[m_staging.getFrameIndex()]) {
+        buffer->destroy();
+    }
+
+    m_retired[m_staging.getFrameIndex()].clear();
+}
+
+}
@@ -0,0 +1,192 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/25/23.
+//
+
+#ifndef YORK_VULKAN_STREAMINGBUFFER_HPP
+#define YORK_VULKAN_STREAMINGBUFFER_HPP
+
+#include <memory>
+
+#include <vulkan/vulkan.hpp>
+
+#include "Silicon/Types.hpp"
+
+#include "Buffer.hpp"
+
+namespace Si::Vulkan {
+
+/**
+ * @brief Host visible staging memory for uploads, with a separate region for each frame in flight.
+ *
+ * A frame's region is only reused once beginFrame is called for it again, by which point the renderer has waited for the GPU to finish
+ * the copies out of it. If a frame needs more than its region holds, more buffers are chained on. The next time the frame comes round
+ * they are merged into one, so a steady workload settles at no allocations per frame.
+ */
+class StagingRing
+{
+public:
+    /**
+     * Where an upload's bytes were staged.
+     */
+    struct Allocation {
+        Buffer *buffer;
+        vk::DeviceSize offset;
+    };
+
+    /**
+     * @param instance The instance the device belongs to.
+     * @param device The device to allocate the staging buffers on.
+     * @param framesInFlight How many frames may be in flight at once.
+     * @param frameCapacity How many bytes each frame can stage before it needs another buffer.
+     */
+    StagingRing(Instance &instance, Device &device, std::uint32_t framesInFlight, std::size_t frameCapacity = 1024 * 1024);
+    ~StagingRing();
+
+    /**
+     * @brief Starts staging for a frame. The GPU must have finished the frame that last used frameIndex.
+     *
+     * @param frameIndex The frame in flight about to be recorded.
+     */
+    void beginFrame(std::uint32_t frameIndex);
+
+    /**
+     * @brief Stages bytes in the current frame's region.
+     *
+     * @param bytes The bytes to stage.
+     * @return Where the bytes are, to copy them out of.
+     */
+    Allocation stage(Span<const std::uint8_t> bytes);
+
+    [[nodiscard]] Instance &getInstance() const;
+    [[nodiscard]] Device &getDevice() const;
+    [[nodiscard]] std::uint32_t getFrameIndex() const;
+    [[nodiscard]] std::uint32_t getFrameCount() const;
+
+    /**
+     * Gets how many frames have begun. Unlike the frame index, this never repeats.
+     *
+     * @return The number of calls to beginFrame.
+     */
+    [[nodiscard]] std::uint64_t getFrameNumber() const;
+
+private:
+    struct Frame {
+        Vector<std::unique_ptr<Buffer>> buffers;
+        std::size_t offset = 0;
+    };
+
+    std::unique_ptr<Buffer> createBuffer(std::size_t size);
+
+    Instance &m_instance;
+    Device &m_device;
+
+    Vector<Frame> m_frames;
+    std::uint32_t m_frameIndex = 0;
+    std::uint64_t m_frameNumber = 0;
+};
+
+/**
+ * @brief A device local buffer that is written from the CPU through a StagingRing, for geometry or uniforms that change every frame.
+ *
+ * Writes are staged straight away and copied into the buffer by flush, which must be recorded before anything that reads the buffer in
+ * the same frame. If a write goes past the end, the buffer grows to at least double its size. The old contents are copied across on the
+ * GPU, and the old buffer is kept alive until the frames that may still read it have finished.
+ */
+class StreamingBuffer
+{
+public:
+    /**
+     * @param staging The staging ring to upload through.
+     * @param usage How the buffer is read, for example vertex, index, uniform or storage.
+     * @param capacity The initial size of the buffer in bytes.
+     */
+    StreamingBuffer(StagingRing &staging, vk::BufferUsageFlags usage, std::size_t capacity = 64 * 1024);
+    ~StreamingBuffer();
+
+    /**
+     * @brief Writes bytes into the buffer, growing it if they do not fit.
+     *
+     * @param bytes The bytes to write.
+     * @param offset Where in the buffer to write them, in bytes.
+     */
+    void write(Span<const std::uint8_t> bytes, std::size_t offset = 0);
+
+    /**
+     * @brief Writes items into the buffer, growing it if they do not fit.
+     *
+     * @param items The items to write.
+     * @param first The index of the item in the buffer to start writing at.
+     */
+    template <typename T>
+    void write(Span<const T> items, std::size_t first = 0)
+    {
+        write(Span<const std::uint8_t>(reinterpret_cast<const std::uint8_t *>(items.data()), items.size_bytes()), first * sizeof(T));
+    }
+
+    /**
+     * @brief Records the copies for every write since the last flush, along with the barriers that order them against the frames
+     * before and the draws after. Call it every frame that writes, before the staging ring moves on to the next frame.
+     *
+     * @param commandBuffer The command buffer to record into, outside of any render pass.
+     */
+    void flush(vk::CommandBuffer commandBuffer);
+
+    [[nodiscard]] Buffer &getBuffer();
+    [[nodiscard]] std::size_t getCapacity() const;
+
+private:
+    struct Copy {
+        vk::Buffer source;
+        vk::BufferCopy region;
+    };
+
+    void reserve(std::size_t size);
+    void releaseRetired();
+
+    StagingRing &m_staging;
+    vk::BufferUsageFlags m_usage;
+
+    std::unique_ptr<Buffer> m_buffer;
+
+    // When the buffer grows, the contents it had at the start of the frame are copied across before this frame's writes.
+    vk::Buffer m_growSource;
+    vk::DeviceSize m_growSize = 0;
+
+    Vector<Copy> m_pending;
+
+    // Buffers replaced by growing, kept until the frame that replaced them comes round again.
+    Vector<Vector<std::unique_ptr<Buffer>>> m_retired;
+    std::uint64_t m_frameNumber = 0;
+};
+
+}
+
+#endif // YORK_VULKAN_STREAMINGBUFFER_HPP
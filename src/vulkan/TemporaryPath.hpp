@@ -0,0 +1,69 @@
+/*
+ * BSD 2-Clause License
+ *
+ * Copyright (c) 2023 Matthew McCall
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+//
+// Created by Matthew McCall on 1/26/23.
+//
+
+#ifndef YORK_VULKAN_TEMPORARYPATH_HPP
+#define YORK_VULKAN_TEMPORARYPATH_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <random>
+
+#include "spdlog/fmt/fmt.h"
+
+namespace Si::Vulkan {
+
+/**
+ * Gets a name to write a cache file under before renaming it into place.
+ *
+ * The name is unique to the calling thread and process, so threads and processes writing the same cache file at once never write
+ * into the same temporary file, and a reader only ever sees a whole file.
+ *
+ * @param path The path the file will be renamed to.
+ * @return The path to write to first.
+ */
+inline std::filesystem::path GetTemporaryPath(const std::filesystem::path &path)
+{
+    // Random rather than the process id, which has no portable way to get it.
+    thread_local std::uint64_t nonce = [] {
+        std::random_device device;
+        return (std::uint64_t {device()} << 32) | device();
+    }();
+
+    std::filesystem::path temporary = path;
+    temporary += fmt::format(".{:016x}.tmp", nonce);
+
+    return temporary;
+}
+
+}
+
+#endif // YORK_VULKAN_TEMPORARYPATH_HPP
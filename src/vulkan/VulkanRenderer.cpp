@@ -28,11 +28,18 @@
 // Created by Matthew McCall on 11/20/22.
 //
 
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+
 #include "Silicon/Event.hpp"
 #include "Silicon/Log.hpp"
 #include "Silicon/Types.hpp"
 #include "Silicon/Renderer/Renderer.hpp"
 #include "Silicon/Renderer/Vertex.hpp"
+#include "Silicon/Renderer/VulkanRenderer.hpp"
 
 #include "Silicon/Event.hpp"
 #include "Silicon/Window.hpp"
@@ -41,66 +48,204 @@
 #include "CommandPool.hpp"
 #include "FrameData.hpp"
 #include "Framebuffer.hpp"
+#include "Image.hpp"
 #include "Pipeline.hpp"
+#include "PipelineCache.hpp"
+#include "SceneRecorder.hpp"
 #include "Semaphore.hpp"
+#include "StreamingBuffer.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Waits until the GPU is done with a fence, counting the wait as a stall in stats if it was not done already.
+ */
+void WaitForFence(Si::Vulkan::Device &device, vk::Fence fence, Si::Renderer::FrameStats &stats)
+{
+    if (device->getFenceStatus(fence) == vk::Result::eSuccess) {
+        return;
+    }
+
+    auto start = Clock::now();
+
+    std::array<vk::Fence, 1> fences = { fence };
+    auto waitResult = device->waitForFences(fences, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+
+    auto stall = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+
+    stats.stalledFrames++;
+    stats.totalStall += stall;
+    stats.maxStall = std::max(stats.maxStall, stall);
+}
+
+/**
+ * Reads a shader's GLSL source from the shaders directory copied next to the executable.
+ */
+std::string ReadShaderSource(const std::string &name)
+{
+    std::ifstream file("shaders/" + name);
+
+    if (!file) {
+        Si::Engine::Error("Failed to open shader {}!", name);
+        return {};
+    }
+
+    return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+}
+
+/**
+ * Requests the pipeline both renderers draw their geometry with, and waits for it to be built.
+ */
+Si::Vulkan::PipelineCache::Id RequestDefaultPipeline(Si::Vulkan::PipelineCache &pipelines, Si::Vulkan::RenderPass &renderPass)
+{
+    using Si::Vulkan::Shader;
+
+    // The two shaders compile at the same time, and come from the SPIR-V cache after the first launch.
+    Si::Future<Si::Vector<std::uint32_t>> vertexShader = Si::Async<Si::Vector<std::uint32_t>>([]() {
+        return Shader::compile(ReadShaderSource("simple.vert"), Shader::Type::Vertex);
+    });
+
+    Si::Vector<std::uint32_t> fragmentShader = Shader::compile(ReadShaderSource("simple.frag"), Shader::Type::Fragment);
+
+    Si::Vulkan::PipelineDescription description;
+    description.renderPass = &renderPass;
+    description.stages.push_back({ Shader::Type::Vertex, vertexShader.get() });
+    description.stages.push_back({ Shader::Type::Fragment, std::move(fragmentShader) });
+
+    Si::Vulkan::PipelineCache::Id id = pipelines.request(description);
+    pipelines.wait(id);
+
+    return id;
+}
+
+// Draws made without any instances set get this one, which leaves the mesh as it is.
+const Si::InstanceData DefaultInstance { { 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+
+/**
+ * Gets the draws queued for this frame, or if none were, a single draw of every index, or every vertex without indices, for every
+ * instance.
+ */
+Si::Span<const Si::Renderer::DrawCommand> GetDraws(const Si::Vector<Si::Renderer::DrawCommand> &queued, Si::Renderer::DrawCommand &fallback, std::size_t vertexCount, std::size_t indexCount, std::size_t instanceCount)
+{
+    if (!queued.empty()) {
+        return { queued.data(), queued.size() };
+    }
+
+    fallback = {};
+    fallback.vertexCount = indexCount ? 0 : static_cast<std::uint32_t>(vertexCount);
+    fallback.indexCount = static_cast<std::uint32_t>(indexCount);
+    fallback.instanceCount = static_cast<std::uint32_t>(std::max<std::size_t>(instanceCount, 1));
+
+    return { &fallback, 1 };
+}
+
+/**
+ * The buffers a renderer's vertices, indices and instances are streamed into every frame, and the staging ring they go through.
+ */
+struct SceneGeometry {
+    SceneGeometry(Si::Vulkan::Instance &instance, Si::Vulkan::Device &device, std::uint32_t framesInFlight)
+        : staging(instance, device, framesInFlight)
+        , vertices(staging, vk::BufferUsageFlagBits::eVertexBuffer)
+        , indices(staging, vk::BufferUsageFlagBits::eIndexBuffer)
+        , instances(staging, vk::BufferUsageFlagBits::eVertexBuffer)
+    {
+    }
+
+    /**
+     * Streams in a frame's geometry. It has to be recorded before the render pass that draws it.
+     */
+    void upload(vk::CommandBuffer commandBuffer, std::uint32_t frameIndex, const Si::Vector<Si::Vertex> &vertexData, const Si::Vector<std::uint32_t> &indexData, const Si::Vector<Si::InstanceData> &instanceData)
+    {
+        staging.beginFrame(frameIndex);
+
+        vertices.write(Si::Span<const Si::Vertex>(vertexData.data(), vertexData.size()));
+        indices.write(Si::Span<const std::uint32_t>(indexData.data(), indexData.size()));
+
+        if (instanceData.empty()) {
+            instances.write(Si::Span<const Si::InstanceData>(&DefaultInstance, 1));
+        } else {
+            instances.write(Si::Span<const Si::InstanceData>(instanceData.data(), instanceData.size()));
+        }
+
+        vertices.flush(commandBuffer);
+        indices.flush(commandBuffer);
+        instances.flush(commandBuffer);
+    }
+
+    Si::Vulkan::SceneRecorder::Geometry getBuffers()
+    {
+        return { vertices.getBuffer(), indices.getBuffer(), instances.getBuffer() };
+    }
+
+    Si::Vulkan::StagingRing staging;
+    Si::Vulkan::StreamingBuffer vertices;
+    Si::Vulkan::StreamingBuffer indices;
+    Si::Vulkan::StreamingBuffer instances;
+};
+
+}
 
 class VulkanRendererImpl : public Si::Renderer
 {
 public:
-    explicit VulkanRendererImpl(Si::Window& window)
+    VulkanRendererImpl(Si::Window& window, std::uint32_t framesInFlight)
         : Si::Renderer()
         , m_window(window)
+        , m_framesInFlight(std::clamp<std::uint32_t>(framesInFlight, 1, Si::VulkanRenderer::MaxFramesInFlight))
         , m_surface(s_instance, window)
         , m_physicalDevice(*Si::Vulkan::PhysicalDevice::getBest(
               s_instance,
-              m_surface,
+              &m_surface,
               {
                   { "VK_KHR_portability_subset", false },
+                  { VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME, false },
                   { VK_KHR_SWAPCHAIN_EXTENSION_NAME }
               }))
         , m_device(m_physicalDevice)
         , m_swapChain(m_device, window, m_surface)
         , m_renderPass(m_device)
-        , m_pipeline(m_renderPass)
+        , m_pipelines(m_device)
         , m_commandPool(m_device)
-        , m_vertexBuffer(s_instance, m_device, sizeof(Si::Vertex) * 3)
+        , m_recorder(m_device, m_framesInFlight)
+        , m_geometry(s_instance, m_device, m_framesInFlight)
         , m_resizeHandler([this](const Si::Event::WindowResize &event) {
             resize = true;
         })
     {
-        m_pipeline.create();
+        m_pipeline = RequestDefaultPipeline(m_pipelines, m_renderPass);
         m_swapChain.create();
 
-        Si::Vector<Si::Vulkan::ImageView>& imageViews = m_swapChain.getImageViews();
-        m_maxFrames = imageViews.size();
-
-        vk::CommandBufferAllocateInfo commandBufferAllocateInfo { *m_commandPool, vk::CommandBufferLevel::ePrimary, static_cast<uint32_t>(m_maxFrames) };
+        // Everything the CPU touches while recording is per frame in flight, everything tied to a swap chain image is per image.
+        vk::CommandBufferAllocateInfo commandBufferAllocateInfo { *m_commandPool, vk::CommandBufferLevel::ePrimary, m_framesInFlight };
         m_commandBuffers = m_device->allocateCommandBuffers<Si::Allocator<vk::CommandBuffer>>(commandBufferAllocateInfo);
 
-        m_fences.reserve(m_maxFrames);
-        m_framebuffers.reserve(m_maxFrames);
-        m_imageAvailableSemaphores.reserve(m_maxFrames);
-        m_renderFinishedSemaphores.reserve(m_maxFrames);
+        m_fences.reserve(m_framesInFlight);
+        m_imageAvailableSemaphores.reserve(m_framesInFlight);
 
-        for (unsigned i = 0; i < m_maxFrames; i++) {
+        for (unsigned i = 0; i < m_framesInFlight; i++) {
             m_fences.emplace_back(m_device);
             m_fences.back().create();
 
-            m_framebuffers.emplace_back(m_renderPass, imageViews[i], m_swapChain);
-            m_framebuffers.back().create();
-
             m_imageAvailableSemaphores.emplace_back(m_device);
             m_imageAvailableSemaphores.back().create();
-
-            m_renderFinishedSemaphores.emplace_back(m_device);
-            m_renderFinishedSemaphores.back().create();
         }
+
+        createImageResources();
+    }
+
+    ~VulkanRendererImpl() override
+    {
+        // Handles are never destroyed on shutdown, so the pipeline cache has to be saved here for the next launch to use it.
+        m_device.savePipelineCache();
     }
 
     bool Draw() override
     {
-        std::array<vk::Fence, 1> fences = { *m_fences[m_frameIndex] };
-        auto waitResult = m_device->waitForFences(fences, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+        vk::Fence frameFence = *m_fences[m_frameIndex];
+
+        WaitForFence(m_device, frameFence, m_frameStats);
 
         auto [result, imageIndex] = m_device->acquireNextImageKHR(*m_swapChain, std::numeric_limits<std::uint64_t>::max(), *m_imageAvailableSemaphores[m_frameIndex], VK_NULL_HANDLE);
 
@@ -112,52 +257,41 @@ public:
             return false;
         }
 
+        // With more images than frames in flight, or when images come back out of order, an older frame can still be rendering to it.
+        if (m_imageFences[imageIndex] && (m_imageFences[imageIndex] != frameFence)) {
+            WaitForFence(m_device, m_imageFences[imageIndex], m_frameStats);
+        }
+
+        m_imageFences[imageIndex] = frameFence;
+
+        std::array<vk::Fence, 1> fences = { frameFence };
         m_device->resetFences(fences);
 
+        m_frameStats.frames++;
+
         vk::CommandBuffer commandBuffer = m_commandBuffers[m_frameIndex];
 
         vk::CommandBufferBeginInfo commandBufferBeginInfo { vk::CommandBufferUsageFlagBits::eOneTimeSubmit };
         commandBuffer.begin(commandBufferBeginInfo);
 
-        vk::Viewport viewport {
-            0,
-            0,
-            static_cast<float>(m_swapChain.getExtent().width),
-            static_cast<float>(m_swapChain.getExtent().height),
-            0,
-            1
-        };
-
-        vk::Rect2D scissor { { 0, 0 }, m_swapChain.getExtent() };
-
-        commandBuffer.setViewport(0, { viewport });
-        commandBuffer.setScissor(0, { scissor });
+        // The geometry may change every frame, so it is streamed in before the render pass reads it.
+        m_geometry.upload(commandBuffer, m_frameIndex, m_vertices, m_indices, m_instances);
 
-        vk::ClearValue clearValue { vk::ClearColorValue().setFloat32({ 0, 0, 0, 0 }) };
-        vk::RenderPassBeginInfo renderPassBeginInfo { *m_renderPass, *(m_framebuffers[imageIndex]), { { 0, 0 }, m_swapChain.getExtent() }, clearValue };
-        commandBuffer.beginRenderPass(renderPassBeginInfo, vk::SubpassContents::eInline);
+        Si::Renderer::DrawCommand fallback;
+        m_recorder.record(commandBuffer, m_frameIndex, m_renderPass, m_framebuffers[imageIndex], m_swapChain.getExtent(), m_pipelines.get(m_pipeline), m_geometry.getBuffers(), GetDraws(m_drawCommands, fallback, m_vertices.size(), m_indices.size(), m_instances.size()));
+        m_drawCommands.clear();
 
-        commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *m_pipeline);
-
-        std::array<vk::Buffer, 1> vertexBuffers { *m_vertexBuffer };
-        std::array<vk::DeviceSize, 1> vertexOffsets { 0 };
-
-        commandBuffer.bindVertexBuffers(0, vertexBuffers, vertexOffsets);
-
-        commandBuffer.draw(m_vertices.size(), 1, 0, 0);
-
-        commandBuffer.endRenderPass();
         commandBuffer.end();
 
         std::array<vk::Semaphore, 1> waitSemaphores { *m_imageAvailableSemaphores[m_frameIndex] };
-        std::array<vk::Semaphore, 1> signalSemaphores { *m_renderFinishedSemaphores[m_frameIndex] };
+        std::array<vk::Semaphore, 1> signalSemaphores { *m_renderFinishedSemaphores[imageIndex] };
         std::array<vk::PipelineStageFlags, 1> waitStages { vk::PipelineStageFlagBits::eColorAttachmentOutput };
 
         std::array<vk::CommandBuffer, 1> commandBuffers = { commandBuffer };
 
         vk::SubmitInfo submitInfo { waitSemaphores, waitStages, commandBuffers, signalSemaphores };
 
-        m_device.getGraphicsQueue().submit({ submitInfo }, *m_fences[m_frameIndex]);
+        m_device.getGraphicsQueue().submit({ submitInfo }, frameFence);
 
         std::array<vk::SwapchainKHR, 1> swapChains { *m_swapChain };
         std::array<std::uint32_t, 1> imageIndices { imageIndex };
@@ -174,7 +308,7 @@ public:
             return false;
         }
 
-        ++m_frameIndex %= m_maxFrames;
+        ++m_frameIndex %= m_framesInFlight;
 
         return true;
     }
@@ -182,13 +316,60 @@ public:
     void OnResize() override
     {
         m_device->waitIdle();
-        m_swapChain.create();
-        m_renderPass.create();
+
+        // The new swap chain replaces the image views the framebuffers point at, and may have a different number of images.
+        destroyImageResources();
+        m_pipelines.waitForBuilds();
+
+        // Together, so whatever depends on both is recreated once rather than once for each.
+        std::array<Si::Vulkan::HandleBase *, 2> handles { &m_swapChain, &m_renderPass };
+        Si::Vulkan::HandleBase::recreate(handles);
+
+        createImageResources();
     }
 
 private:
+    /**
+     * Creates the framebuffer, render finished semaphore and fence slot of every swap chain image.
+     */
+    void createImageResources()
+    {
+        Si::Vector<Si::Vulkan::ImageView>& imageViews = m_swapChain.getImageViews();
+
+        // Handles point at each other, so these must never move once constructed.
+        m_framebuffers.reserve(imageViews.size());
+        m_renderFinishedSemaphores.reserve(imageViews.size());
+        m_imageFences.assign(imageViews.size(), vk::Fence {});
+
+        for (unsigned i = 0; i < imageViews.size(); i++) {
+            m_framebuffers.emplace_back(m_renderPass, imageViews[i], m_swapChain);
+            m_framebuffers.back().create();
+
+            m_renderFinishedSemaphores.emplace_back(m_device);
+            m_renderFinishedSemaphores.back().create();
+        }
+    }
+
+    /**
+     * Destroys everything createImageResources made. The device must be idle.
+     */
+    void destroyImageResources()
+    {
+        for (Si::Vulkan::Framebuffer &framebuffer : m_framebuffers) {
+            framebuffer.destroy();
+        }
+
+        for (Si::Vulkan::Semaphore &semaphore : m_renderFinishedSemaphores) {
+            semaphore.destroy();
+        }
+
+        m_framebuffers.clear();
+        m_renderFinishedSemaphores.clear();
+        m_imageFences.clear();
+    }
 
     Si::Window &m_window;
+    std::uint32_t m_framesInFlight;
 
     static Si::Vulkan::Instance s_instance;
 
@@ -197,9 +378,11 @@ private:
     Si::Vulkan::Device m_device;
     Si::Vulkan::SwapChain m_swapChain;
     Si::Vulkan::RenderPass m_renderPass;
-    Si::Vulkan::Pipeline m_pipeline;
+    Si::Vulkan::PipelineCache m_pipelines;
+    Si::Vulkan::PipelineCache::Id m_pipeline = 0;
     Si::Vulkan::CommandPool m_commandPool;
-    Si::Vulkan::Buffer m_vertexBuffer;
+    Si::Vulkan::SceneRecorder m_recorder;
+    SceneGeometry m_geometry;
     
     Si::Vector<Si::Vulkan::Framebuffer> m_framebuffers;
     Si::Vector<Si::Vulkan::Fence> m_fences;
@@ -208,16 +391,204 @@ private:
 
     Si::Vector<vk::CommandBuffer> m_commandBuffers;
 
+    // The fence of the frame that last rendered to each swap chain image.
+    Si::Vector<vk::Fence> m_imageFences;
+
     Si::Sub<Si::Event::WindowResize> m_resizeHandler;
 
     std::uint32_t m_frameIndex = 0;
-    std::uint32_t m_maxFrames = 0;
 
     bool resize = false;
 };
 
 Si::Vulkan::Instance VulkanRendererImpl::s_instance {};
 
+/**
+ * Renders into offscreen images and copies every frame into a mapped buffer instead of presenting it. There is no window, surface or
+ * swap chain, so it runs on a software ICD with no display. Frames rotate through a small ring, so the next frame records and renders
+ * while the last one is read back.
+ */
+class HeadlessRendererImpl : public Si::Renderer
+{
+public:
+    HeadlessRendererImpl(std::uint32_t width, std::uint32_t height, std::uint32_t framesInFlight)
+        : Si::Renderer()
+        , m_extent { width, height }
+        , m_framesInFlight(std::clamp<std::uint32_t>(framesInFlight, 1, Si::VulkanRenderer::MaxFramesInFlight))
+        , m_physicalDevice(*Si::Vulkan::PhysicalDevice::getBest(
+              s_instance,
+              nullptr,
+              {
+                  { "VK_KHR_portability_subset", false },
+                  { VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME, false }
+              }))
+        , m_device(m_physicalDevice)
+        , m_renderPass(m_device, ColorFormat, vk::ImageLayout::eTransferSrcOptimal)
+        , m_pipelines(m_device)
+        , m_commandPool(m_device)
+        , m_recorder(m_device, m_framesInFlight)
+        , m_geometry(s_instance, m_device, m_framesInFlight)
+    {
+        m_pipeline = RequestDefaultPipeline(m_pipelines, m_renderPass);
+
+        vk::CommandBufferAllocateInfo commandBufferAllocateInfo { *m_commandPool, vk::CommandBufferLevel::ePrimary, m_framesInFlight };
+        Si::Vector<vk::CommandBuffer> commandBuffers = m_device->allocateCommandBuffers<Si::Allocator<vk::CommandBuffer>>(commandBufferAllocateInfo);
+
+        // Handles point at each other, so the frames must never move once constructed.
+        m_frames.reserve(m_framesInFlight);
+
+        for (std::uint32_t i = 0; i < m_framesInFlight; i++) {
+            m_frames.emplace_back(*this, commandBuffers[i]);
+        }
+    }
+
+    /**
+     * Gets whether there is a device to render with. Machines without any Vulkan driver fail to create the instance at all.
+     */
+    static bool HasDevice()
+    {
+        try {
+            return !s_instance->enumeratePhysicalDevices().empty();
+        } catch (const vk::SystemError &error) {
+            Si::Engine::Error("Failed to create a Vulkan instance: {}", error.what());
+            return false;
+        }
+    }
+
+    ~HeadlessRendererImpl() override
+    {
+        m_device.savePipelineCache();
+    }
+
+    bool Draw() override
+    {
+        Frame &frame = m_frames[m_frameIndex];
+
+        WaitForFence(m_device, *frame.fence, m_frameStats);
+
+        std::array<vk::Fence, 1> fences = { *frame.fence };
+        m_device->resetFences(fences);
+
+        m_frameStats.frames++;
+
+        vk::CommandBuffer commandBuffer = frame.commandBuffer;
+
+        vk::CommandBufferBeginInfo commandBufferBeginInfo { vk::CommandBufferUsageFlagBits::eOneTimeSubmit };
+        commandBuffer.begin(commandBufferBeginInfo);
+
+        m_geometry.upload(commandBuffer, m_frameIndex, m_vertices, m_indices, m_instances);
+
+        Si::Renderer::DrawCommand fallback;
+        m_recorder.record(commandBuffer, m_frameIndex, m_renderPass, frame.framebuffer, m_extent, m_pipelines.get(m_pipeline), m_geometry.getBuffers(), GetDraws(m_drawCommands, fallback, m_vertices.size(), m_indices.size(), m_instances.size()));
+        m_drawCommands.clear();
+
+        // The render pass leaves the image in eTransferSrcOptimal and orders the copy after its writes.
+        vk::BufferImageCopy region {
+            0,
+            0,
+            0,
+            { vk::ImageAspectFlagBits::eColor, 0, 0, 1 },
+            { 0, 0, 0 },
+            { m_extent.width, m_extent.height, 1 }
+        };
+
+        commandBuffer.copyImageToBuffer(*frame.image, vk::ImageLayout::eTransferSrcOptimal, *frame.readback, { region });
+
+        vk::BufferMemoryBarrier readbackBarrier {
+            vk::AccessFlagBits::eTransferWrite,
+            vk::AccessFlagBits::eHostRead,
+            VK_QUEUE_FAMILY_IGNORED,
+            VK_QUEUE_FAMILY_IGNORED,
+            *frame.readback,
+            0,
+            VK_WHOLE_SIZE
+        };
+
+        commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eHost, {}, {}, { readbackBarrier }, {});
+
+        commandBuffer.end();
+
+        std::array<vk::CommandBuffer, 1> commandBuffers = { commandBuffer };
+
+        vk::SubmitInfo submitInfo { {}, {}, commandBuffers, {} };
+
+        m_device.getGraphicsQueue().submit({ submitInfo }, *frame.fence);
+
+        m_lastFrame = m_frameIndex;
+        ++m_frameIndex %= m_framesInFlight;
+
+        return true;
+    }
+
+    Si::Span<const std::uint8_t> GetPixels() override
+    {
+        if (m_lastFrame == NoFrame) {
+            return {};
+        }
+
+        Frame &frame = m_frames[m_lastFrame];
+
+        WaitForFence(m_device, *frame.fence, m_frameStats);
+
+        return frame.readback.getData();
+    }
+
+protected:
+    void OnResize() override
+    {
+    }
+
+private:
+    static constexpr std::uint32_t NoFrame = std::numeric_limits<std::uint32_t>::max();
+    static constexpr vk::Format ColorFormat = vk::Format::eR8G8B8A8Unorm;
+
+    /**
+     * Everything one frame in flight renders into and reads back from.
+     */
+    struct Frame {
+        Frame(HeadlessRendererImpl &renderer, vk::CommandBuffer buffer)
+            : image(s_instance, renderer.m_device, renderer.m_extent, ColorFormat, vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc)
+            , imageView(image)
+            , framebuffer(renderer.m_renderPass, imageView, renderer.m_extent)
+            , readback(s_instance, renderer.m_device, std::size_t { renderer.m_extent.width } * renderer.m_extent.height * 4, vk::BufferUsageFlagBits::eTransferDst, Si::Vulkan::Buffer::HostAccess::Random)
+            , fence(renderer.m_device)
+            , commandBuffer(buffer)
+        {
+            framebuffer.create();
+            readback.create();
+            fence.create();
+        }
+
+        Si::Vulkan::Image image;
+        Si::Vulkan::ImageView imageView;
+        Si::Vulkan::Framebuffer framebuffer;
+        Si::Vulkan::Buffer readback;
+        Si::Vulkan::Fence fence;
+        vk::CommandBuffer commandBuffer;
+    };
+
+    static Si::Vulkan::Instance s_instance;
+
+    vk::Extent2D m_extent;
+    std::uint32_t m_framesInFlight;
+
+    Si::Vulkan::PhysicalDevice m_physicalDevice;
+    Si::Vulkan::Device m_device;
+    Si::Vulkan::RenderPass m_renderPass;
+    Si::Vulkan::PipelineCache m_pipelines;
+    Si::Vulkan::PipelineCache::Id m_pipeline = 0;
+    Si::Vulkan::CommandPool m_commandPool;
+    Si::Vulkan::SceneRecorder m_recorder;
+    SceneGeometry m_geometry;
+
+    Si::Vector<Frame> m_frames;
+
+    std::uint32_t m_frameIndex = 0;
+    std::uint32_t m_lastFrame = NoFrame;
+};
+
+Si::Vulkan::Instance HeadlessRendererImpl::s_instance { true };
+
 namespace Si::VulkanRenderer {
 
 void Initialize()
@@ -228,9 +599,19 @@ void Deinitialize()
 {
 }
 
-void Create(Window &window)
+void Create(Window &window, std::uint32_t framesInFlight)
 {
-    Renderer::RegisterRenderer("Si::Vulkan", std::make_unique<VulkanRendererImpl>(window));
+    Renderer::RegisterRenderer("Si::Vulkan", std::make_unique<VulkanRendererImpl>(window, framesInFlight));
+}
+
+bool CreateHeadless(std::uint32_t width, std::uint32_t height, std::uint32_t framesInFlight)
+{
+    if (!HeadlessRendererImpl::HasDevice()) {
+        return false;
+    }
+
+    Renderer::RegisterRenderer("Si::Vulkan::Headless", std::make_unique<HeadlessRendererImpl>(width, height, framesInFlight));
+    return true;
 }
 
 }
\ No newline at end of file
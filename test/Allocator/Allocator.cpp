@@ -0,0 +1,166 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/21/23.
+//
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#include "Silicon/Allocator.hpp"
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+#include "Silicon/Types.hpp"
+
+namespace {
+
+bool IsAligned(const void *pointer, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+bool TestArena()
+{
+    Si::Arena arena(256);
+
+    void *a = arena.Allocate(10, 1);
+    void *b = arena.Allocate(8, 8);
+    void *c = arena.Allocate(64, 64);
+
+    if (!IsAligned(b, 8) || !IsAligned(c, 64) || a == b) {
+        Si::Error("Arena allocations are misaligned");
+        return false;
+    }
+
+    // Larger than a block.
+    void *large = arena.Allocate(1000);
+
+    if (arena.GetUsed() != 1082 || arena.GetCapacity() < 1256) {
+        Si::Error("Arena reported {} bytes used and {} reserved", arena.GetUsed(), arena.GetCapacity());
+        return false;
+    }
+
+    std::size_t capacity = arena.GetCapacity();
+    arena.Reset();
+
+    if (arena.GetUsed() != 0 || arena.Allocate(10, 1) != a) {
+        Si::Error("Arena did not reuse its memory after a reset");
+        return false;
+    }
+
+    arena.Allocate(1000);
+
+    if (arena.GetCapacity() != capacity) {
+        Si::Error("Arena grew after a reset");
+        return false;
+    }
+
+    return true;
+}
+
+bool TestFrameArena()
+{
+    bool passed = true;
+    Si::SetLoop([&passed]() {
+        Si::FrameVector<std::string> strings;
+
+        for (int i = 0; i < 100; i++) {
+            strings.emplace_back("A string long enough to not fit in the small buffer " + std::to_string(i));
+        }
+
+        passed &= strings[99].back() == '9';
+        passed &= Si::GetFrameArena().GetUsed() > 0;
+
+        return false;
+    });
+
+    Si::Loop();
+
+    if (!passed || Si::GetFrameArena().GetUsed() != 0) {
+        Si::Error("Frame arena was not reset at the end of the frame");
+        return false;
+    }
+
+    return true;
+}
+
+bool TestThreadLocal()
+{
+    Si::ThreadLocalVector<std::uint64_t> shared;
+
+    // Grow on one thread and free on another.
+    std::thread worker([&shared]() {
+        for (std::uint64_t i = 0; i < 10000; i++) {
+            shared.push_back(i);
+        }
+
+        Si::ThreadLocalVector<std::uint64_t> local(shared.begin(), shared.begin() + 10);
+        local.clear();
+        local.shrink_to_fit();
+    });
+
+    worker.join();
+
+    std::uint64_t sum = 0;
+
+    for (std::uint64_t i : shared) {
+        sum += i;
+    }
+
+    shared = {};
+
+    void *first = Si::ThreadLocalAllocate(24);
+    Si::ThreadLocalFree(first, 24);
+    void *second = Si::ThreadLocalAllocate(32);
+
+    if (sum != 49995000 || first != second || !IsAligned(second, alignof(std::max_align_t))) {
+        Si::Error("Thread local allocator did not reuse a freed block");
+        return false;
+    }
+
+    Si::ThreadLocalFree(second, 32);
+
+    return true;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    bool passed = TestArena() && TestFrameArena() && TestThreadLocal();
+
+    Si::Deinitialize();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
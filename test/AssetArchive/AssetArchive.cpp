@@ -0,0 +1,168 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/17/23.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Silicon/Archive.hpp"
+#include "Silicon/Asset.hpp"
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+
+namespace {
+
+Si::Span<const std::uint8_t> AsBytes(const std::string &text)
+{
+    return {reinterpret_cast<const std::uint8_t *>(text.data()), text.size()};
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    const std::string archivePath = "AssetArchive.sipk";
+
+    std::string repetitive;
+    for (int i = 0; i < 10000; i++) {
+        repetitive += "vertex " + std::to_string(i % 37) + " ";
+    }
+
+    std::string noise(100000, '\0');
+    std::mt19937 random(42);
+    for (char &c : noise) {
+        c = static_cast<char>(random());
+    }
+
+    const std::pair<std::string, std::string> files[] = {
+        {"shaders/simple.vert", "#version 450\nvoid main() {}\n"},
+        {"meshes/repetitive.txt", repetitive},
+        {"textures/noise.bin", noise},
+        {"empty.txt", ""},
+    };
+
+    Si::ArchiveWriter writer;
+    for (const auto &[path, contents] : files) {
+        writer.Add(path, AsBytes(contents), Si::Archive::Compression::LZ);
+    }
+
+    if (!writer.Write(archivePath)) {
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream("loose.txt") << "loose";
+
+    {
+        auto archive = Si::Archive::Mount(archivePath);
+
+        if (archive->GetEntryCount() != std::size(files) || archive->Find("missing.txt")) {
+            Si::Error("Archive has the wrong entries");
+            return EXIT_FAILURE;
+        }
+
+        if (archive->Find("meshes/repetitive.txt")->compression != Si::Archive::Compression::LZ ||
+            archive->Find("textures/noise.bin")->compression != Si::Archive::Compression::None) {
+            Si::Error("Archive entries were compressed when they should not have been, or not when they should");
+            return EXIT_FAILURE;
+        }
+
+        // None of these exist on disk, they can only come from the archive.
+        for (const auto &[path, contents] : files) {
+            if (Si::Asset::GetNow<Si::PlainTextAsset>(path)->GetText() != contents) {
+                Si::Error("Archived asset {} has the wrong contents", path);
+                return EXIT_FAILURE;
+            }
+        }
+
+        if (Si::Asset::GetNow<Si::PlainTextAsset>("loose.txt")->GetText() != "loose") {
+            Si::Error("Loose files are not loaded when missing from mounted archives");
+            return EXIT_FAILURE;
+        }
+
+        Si::Archive::Unmount(archivePath);
+    }
+
+    // An entry table without empty slots would make lookups of missing paths probe forever, so it must be rejected.
+    {
+        std::ifstream in(archivePath, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        Si::Archive::Header header {};
+        std::memcpy(&header, bytes.data(), sizeof(header));
+
+        for (std::uint32_t i = 0; i < header.slotCount; i++) {
+            char *slot = bytes.data() + header.tableOffset + i * sizeof(Si::Archive::Entry);
+
+            Si::Archive::Entry entry {};
+            std::memcpy(&entry, slot, sizeof(entry));
+
+            if (entry.pathLength == 0) {
+                entry.pathLength = 1;
+                std::memcpy(slot, &entry, sizeof(entry));
+            }
+        }
+
+        const std::string fullPath = "AssetArchiveFull.sipk";
+        std::ofstream(fullPath, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+        bool rejected = false;
+
+        try {
+            Si::Archive archive(fullPath);
+        } catch (const std::runtime_error &) {
+            rejected = true;
+        }
+
+        std::remove(fullPath.c_str());
+
+        if (!rejected) {
+            Si::Error("Archive with a full entry table was accepted");
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::remove("loose.txt");
+    std::remove(archivePath.c_str());
+
+    Si::Deinitialize();
+
+    return EXIT_SUCCESS;
+}
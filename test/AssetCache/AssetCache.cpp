@@ -0,0 +1,136 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/18/23.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include "Silicon/Asset.hpp"
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+
+namespace {
+
+int s_loads = 0;
+
+class CountingAsset : public Si::PlainTextAsset
+{
+public:
+    explicit CountingAsset(std::string path)
+        : PlainTextAsset(std::move(path))
+    {
+        s_loads++;
+    }
+};
+
+std::string AssetPath(int i)
+{
+    return "AssetCache" + std::to_string(i) + ".txt";
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    constexpr int assetCount = 4;
+    constexpr std::size_t assetSize = 1000;
+
+    for (int i = 0; i < assetCount; i++) {
+        std::ofstream(AssetPath(i)) << std::string(assetSize, static_cast<char>('a' + i));
+    }
+
+    // Room for three assets.
+    Si::Asset::SetCacheBudget(3 * assetSize);
+
+    for (int i = 0; i < 3; i++) {
+        Si::Asset::GetNow<CountingAsset>(AssetPath(i));
+    }
+
+    // Released, but still resident.
+    for (int i = 0; i < 3; i++) {
+        Si::Asset::GetNow<CountingAsset>(AssetPath(i));
+    }
+
+    Si::Asset::CacheStats stats = Si::Asset::GetCacheStats();
+
+    if (s_loads != 3 || stats.hits != 3 || stats.misses != 3 || stats.residentBytes != 3 * assetSize || stats.residentCount != 3) {
+        Si::Error("Released assets were not kept resident ({} loads, {} hits, {} misses, {} bytes)", s_loads, stats.hits, stats.misses,
+            stats.residentBytes);
+        return EXIT_FAILURE;
+    }
+
+    // Asset 0 was used least recently, so loading a fourth evicts it.
+    Si::Asset::GetNow<CountingAsset>(AssetPath(3));
+    stats = Si::Asset::GetCacheStats();
+
+    if (stats.evictions != 1 || stats.residentBytes != 3 * assetSize) {
+        Si::Error("Expected one eviction, got {} with {} bytes resident", stats.evictions, stats.residentBytes);
+        return EXIT_FAILURE;
+    }
+
+    Si::Asset::GetNow<CountingAsset>(AssetPath(1));
+
+    if (s_loads != 4) {
+        Si::Error("A resident asset was reloaded");
+        return EXIT_FAILURE;
+    }
+
+    Si::Asset::GetNow<CountingAsset>(AssetPath(0));
+
+    if (s_loads != 5) {
+        Si::Error("The least recently used asset was not the one evicted");
+        return EXIT_FAILURE;
+    }
+
+    // Assets still in use stay loaded even when evicted.
+    auto held = Si::Asset::GetNow<CountingAsset>(AssetPath(3));
+    Si::Asset::SetCacheBudget(0);
+
+    if (Si::Asset::GetCacheStats().residentBytes != 0 || Si::Asset::GetNow<CountingAsset>(AssetPath(3)) != held || s_loads != 5) {
+        Si::Error("An asset in use was unloaded");
+        return EXIT_FAILURE;
+    }
+
+    held.reset();
+
+    for (int i = 0; i < assetCount; i++) {
+        std::remove(AssetPath(i).c_str());
+    }
+
+    Si::Deinitialize();
+
+    return EXIT_SUCCESS;
+}
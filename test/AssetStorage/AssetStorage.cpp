@@ -0,0 +1,101 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/16/23.
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include "Silicon/Asset.hpp"
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+
+namespace {
+
+class ReadTextAsset : public Si::PlainTextAsset
+{
+public:
+    explicit ReadTextAsset(std::string path)
+        : PlainTextAsset(std::move(path), Storage::Read)
+    {
+    }
+};
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    const std::string path = "AssetStorage.txt";
+    const std::string emptyPath = "AssetStorageEmpty.txt";
+    const std::string text = "Hello, Silicon!\nThe quick brown fox jumps over the lazy dog.";
+
+    std::ofstream(path) << text;
+    std::ofstream(emptyPath).flush();
+
+    {
+        auto mapped = Si::Asset::GetNow<Si::PlainTextAsset>(path);
+        // Requests for one path must ask for the same type, so load the copy under a different path.
+        auto read = Si::Asset::GetNow<ReadTextAsset>("./" + path);
+
+        if (mapped->GetText() != text || read->GetText() != text) {
+            Si::Error("Asset text does not match the file");
+            return EXIT_FAILURE;
+        }
+
+        if (read->GetStorage() != Si::Asset::Storage::Read) {
+            Si::Error("Asset was not read into memory");
+            return EXIT_FAILURE;
+        }
+
+        if (mapped->GetBytes().size() != text.size()) {
+            Si::Error("Asset has {} bytes, expected {}", mapped->GetBytes().size(), text.size());
+            return EXIT_FAILURE;
+        }
+
+        auto empty = Si::Asset::GetNow<Si::PlainTextAsset>(emptyPath);
+
+        if (!empty->GetText().empty() || !empty->GetBytes().empty()) {
+            Si::Error("Empty asset is not empty");
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::remove(path.c_str());
+    std::remove(emptyPath.c_str());
+
+    Si::Deinitialize();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,190 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/15/23.
+//
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Silicon/Asset.hpp"
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+
+namespace {
+
+std::atomic<int> s_loads = 0;
+std::shared_future<void> s_gate;
+
+class CountingAsset : public Si::PlainTextAsset
+{
+public:
+    explicit CountingAsset(std::string path)
+        : PlainTextAsset(std::move(path))
+    {
+        s_loads++;
+    }
+};
+
+// Blocks an I/O thread until the gate opens.
+class GatedAsset : public Si::PlainTextAsset
+{
+public:
+    explicit GatedAsset(std::string path)
+        : PlainTextAsset(std::move(path))
+    {
+        s_gate.wait();
+    }
+};
+
+std::string AssetPath(int i)
+{
+    return "AssetStreaming" + std::to_string(i) + ".txt";
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    constexpr int assetCount = 200;
+    constexpr int threadCount = 4;
+
+    // Released assets must unload, so later requests actually queue a load.
+    Si::Asset::SetCacheBudget(0);
+
+    for (int i = 0; i < assetCount; i++) {
+        std::ofstream(AssetPath(i)) << i;
+    }
+
+    // Every thread requests every asset, each should still only load once.
+    std::vector<std::vector<Si::Asset::Request<CountingAsset>>> requests(threadCount);
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&requests, t]() {
+            for (int i = 0; i < assetCount; i++) {
+                requests[t].push_back(Si::Asset::Get<CountingAsset>(AssetPath(i)));
+            }
+        });
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 0; t < threadCount; t++) {
+        for (int i = 0; i < assetCount; i++) {
+            if (requests[t][i].get()->GetText() != std::to_string(i)) {
+                Si::Error("Asset {} has the wrong contents", AssetPath(i));
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    if (s_loads != assetCount) {
+        Si::Error("Loaded {} assets, expected {}", s_loads.load(), assetCount);
+        return EXIT_FAILURE;
+    }
+
+    // Already loaded, so this is served from the cache.
+    if (Si::Asset::GetNow<CountingAsset>(AssetPath(0))->GetText() != "0" || s_loads != assetCount) {
+        Si::Error("GetNow() reloaded a cached asset");
+        return EXIT_FAILURE;
+    }
+
+    requests.clear();
+
+    // Occupy every I/O thread so the next request stays queued, then cancel it.
+    std::promise<void> gate;
+    s_gate = gate.get_future().share();
+
+    std::vector<Si::Asset::Request<GatedAsset>> gated;
+
+    // Gated assets use their own paths, requests for a path must all ask for the same type.
+    for (int i = 100; i < 116; i++) {
+        gated.push_back(Si::Asset::Get<GatedAsset>(AssetPath(i), Si::Asset::Priority::High));
+    }
+
+    auto cancelled = Si::Asset::Get<CountingAsset>(AssetPath(0), Si::Asset::Priority::Low);
+    auto kept = Si::Asset::Get<CountingAsset>(AssetPath(0), Si::Asset::Priority::Low);
+    auto withdrawn = Si::Asset::Get<CountingAsset>(AssetPath(0), Si::Asset::Priority::Low);
+
+    cancelled.cancel();
+
+    gate.set_value();
+
+    if (!kept.get() || !withdrawn.get()) {
+        Si::Error("A load was cancelled while another request still needed it");
+        return EXIT_FAILURE;
+    }
+
+    kept = {};
+    withdrawn = {};
+    cancelled = {};
+
+    for (auto &request : gated) {
+        request.wait();
+    }
+
+    std::promise<void> secondGate;
+    s_gate = secondGate.get_future().share();
+
+    for (int i = 116; i < 132; i++) {
+        gated.push_back(Si::Asset::Get<GatedAsset>(AssetPath(i), Si::Asset::Priority::High));
+    }
+
+    auto alone = Si::Asset::Get<CountingAsset>(AssetPath(assetCount - 1), Si::Asset::Priority::Low);
+    alone.cancel();
+
+    secondGate.set_value();
+
+    if (alone.get()) {
+        Si::Error("A cancelled load still ran");
+        return EXIT_FAILURE;
+    }
+
+    gated.clear();
+
+    for (int i = 0; i < assetCount; i++) {
+        std::remove(AssetPath(i).c_str());
+    }
+
+    Si::Deinitialize();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,204 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/12/23.
+//
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Silicon/Event.hpp"
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+
+struct TickEvent
+{
+    int value;
+};
+
+struct NestedEvent
+{
+    int value;
+};
+
+struct DualEvent
+{
+    int publisher;
+};
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    constexpr int churnCount = 500;
+
+    std::atomic<long> published = 0;
+    std::atomic<long> persistentSum = 0;
+    std::atomic<int> churnCalls = 0;
+    std::atomic<bool> publishing = true;
+
+    Si::Sub<TickEvent> persistent([&persistentSum](const TickEvent &event) {
+        persistentSum += event.value;
+    });
+
+    std::vector<std::thread> publishers;
+
+    for (int i = 0; i < 4; i++) {
+        publishers.emplace_back([&published, &publishing]() {
+            while (publishing) {
+                Si::Pub(TickEvent {1});
+                published++;
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    // Subscribe and unsubscribe while the publishers are running. A subscriber must never be called after it has been destroyed.
+    std::thread churn([&]() {
+        for (int i = 0; i < churnCount; i++) {
+            auto alive = std::make_shared<std::atomic<bool>>(true);
+
+            {
+                Si::Sub<TickEvent> sub([alive, &churnCalls](const TickEvent &) {
+                    if (!*alive) {
+                        std::abort();
+                    }
+
+                    churnCalls++;
+                });
+
+                std::this_thread::yield();
+            }
+
+            *alive = false;
+        }
+    });
+
+    churn.join();
+    publishing = false;
+
+    for (std::thread &publisher : publishers) {
+        publisher.join();
+    }
+
+    Si::Info("Published {} events, persistent subscriber saw {}, churned subscribers saw {}", published.load(), persistentSum.load(), churnCalls.load());
+
+    // A callback subscribing and unsubscribing on one thread while another thread unsubscribes must not deadlock: the unsubscribing
+    // thread waits for the publish to finish, so it must not hold the lock the callback needs meanwhile.
+    std::atomic<bool> done = false;
+    std::atomic<int> nestedCalls = 0;
+
+    std::thread watchdog([&done]() {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+
+        while (!done) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                Si::Error("Subscribing or unsubscribing from a callback deadlocked with another thread");
+                std::abort();
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+
+    Si::Sub<NestedEvent> nesting([&nestedCalls](const NestedEvent &) {
+        // Give the other thread time to start unsubscribing, which then waits on this publish.
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+        Si::Sub<NestedEvent> nested([](const NestedEvent &) {});
+        nestedCalls++;
+    });
+
+    std::thread nestedPublisher([]() {
+        for (int i = 0; i < churnCount; i++) {
+            Si::Pub(NestedEvent {i});
+        }
+    });
+
+    std::thread unsubscriber([]() {
+        for (int i = 0; i < churnCount; i++) {
+            Si::Sub<NestedEvent> sub([](const NestedEvent &) {});
+            std::this_thread::yield();
+        }
+    });
+
+    nestedPublisher.join();
+    unsubscriber.join();
+
+    // Two threads publishing the same event, each destroying a different subscriber from inside a callback, must not wait on each
+    // other. Both callbacks are held until the other publish is running too, so each removal happens while the other thread reads.
+    constexpr int dualCount = 200;
+
+    std::array<std::unique_ptr<Si::Sub<DualEvent>>, 2> victims;
+    std::atomic<int> arrived = 0;
+    int dualRemovals = 0;
+
+    Si::Sub<DualEvent> remover([&victims, &arrived](const DualEvent &event) {
+        arrived++;
+
+        while (arrived < 2) {
+            std::this_thread::yield();
+        }
+
+        victims[event.publisher].reset();
+    });
+
+    for (int i = 0; i < dualCount; i++) {
+        for (auto &victim : victims) {
+            victim = std::make_unique<Si::Sub<DualEvent>>([](const DualEvent &) {});
+        }
+
+        arrived = 0;
+
+        std::thread first([]() { Si::Pub(DualEvent {0}); });
+        std::thread second([]() { Si::Pub(DualEvent {1}); });
+
+        first.join();
+        second.join();
+
+        if (!victims[0] && !victims[1]) {
+            dualRemovals++;
+        }
+    }
+
+    done = true;
+    watchdog.join();
+
+    Si::Info("Nesting subscriber was called {} times, both callbacks removed their subscriber {} times", nestedCalls.load(), dualRemovals);
+
+    Si::Deinitialize();
+
+    return ((persistentSum == published) && (nestedCalls == churnCount) && (dualRemovals == dualCount)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,86 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/11/23.
+//
+
+#include <cstdlib>
+
+#include "Silicon/Event.hpp"
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+
+struct CountEvent
+{
+    int value;
+};
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    constexpr int eventCount = 1000;
+
+    int batches = 0;
+    int batchedEvents = 0;
+    int singleEvents = 0;
+    int sum = 0;
+
+    {
+        Si::Sub<CountEvent> batchSub([&](Si::Span<const CountEvent> events) {
+            batches++;
+            batchedEvents += static_cast<int>(events.size());
+        });
+
+        Si::Sub<CountEvent> singleSub([&](const CountEvent &event) {
+            singleEvents++;
+            sum += event.value;
+        });
+
+        for (int i = 0; i < eventCount; i++) {
+            Si::Enqueue(CountEvent {i});
+        }
+
+        if (batches || singleEvents) {
+            Si::Error("Queued events were delivered before Si::Event::Process()");
+            return EXIT_FAILURE;
+        }
+
+        Si::Event::Process();
+        Si::Event::Process();
+    }
+
+    Si::Info("Delivered {} events in {} batch(es)", batchedEvents, batches);
+
+    Si::Deinitialize();
+
+    bool success = (batches == 1) && (batchedEvents == eventCount) && (singleEvents == eventCount) && (sum == (eventCount * (eventCount - 1)) / 2);
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,251 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/26/23.
+//
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+
+#include "vulkan/Handle.hpp"
+
+namespace {
+
+class Stub;
+
+struct Call {
+    enum class Kind { Create, Destroy } kind;
+    const Stub *handle;
+};
+
+/**
+ * Every createImpl and destroyImpl, in the order they ran. Handles on the same level are created in parallel.
+ */
+struct CallLog {
+    std::mutex mutex;
+    std::vector<Call> calls;
+
+    void add(Call::Kind kind, const Stub *handle)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        calls.push_back({kind, handle});
+    }
+
+    [[nodiscard]] std::size_t count(Call::Kind kind, const Stub *handle) const
+    {
+        return std::count_if(calls.begin(), calls.end(), [kind, handle](const Call &call) {
+            return (call.kind == kind) && (call.handle == handle);
+        });
+    }
+
+    [[nodiscard]] std::size_t indexOf(Call::Kind kind, const Stub *handle) const
+    {
+        return std::find_if(calls.begin(), calls.end(), [kind, handle](const Call &call) {
+            return (call.kind == kind) && (call.handle == handle);
+        }) - calls.begin();
+    }
+};
+
+/**
+ * A handle that creates nothing, and only records when it is created and destroyed.
+ */
+class Stub : public Si::Vulkan::HandleBase
+{
+public:
+    Stub(std::string name, CallLog &log)
+        : m_name(std::move(name))
+        , m_log(log)
+    {
+    }
+
+    void dependOn(Stub &other)
+    {
+        addDependency(other);
+        m_dependencies.push_back(&other);
+    }
+
+    [[nodiscard]] const std::string &getName() const
+    {
+        return m_name;
+    }
+
+    [[nodiscard]] const std::vector<Stub *> &getDependencies() const
+    {
+        return m_dependencies;
+    }
+
+protected:
+    bool createImpl() override
+    {
+        m_log.add(Call::Kind::Create, this);
+        return true;
+    }
+
+    void destroyImpl() override
+    {
+        m_log.add(Call::Kind::Destroy, this);
+    }
+
+private:
+    std::string m_name;
+    CallLog &m_log;
+    std::vector<Stub *> m_dependencies;
+};
+
+/**
+ * Checks that exactly the expected handles were recreated once each, every one destroyed before its dependencies and created after them.
+ */
+bool ExpectRecreated(const CallLog &log, const std::vector<Stub *> &handles, const std::vector<Stub *> &recreated)
+{
+    bool passed = true;
+
+    for (Stub *handle : handles) {
+        std::size_t expected = std::count(recreated.begin(), recreated.end(), handle);
+        std::size_t creates = log.count(Call::Kind::Create, handle);
+        std::size_t destroys = log.count(Call::Kind::Destroy, handle);
+
+        if ((creates != expected) || (destroys != expected)) {
+            Si::Error("{} was created {} and destroyed {} times, expected {}", handle->getName(), creates, destroys, expected);
+            passed = false;
+        }
+    }
+
+    for (Stub *handle : recreated) {
+        for (Stub *dependency : handle->getDependencies()) {
+            if (std::find(recreated.begin(), recreated.end(), dependency) == recreated.end()) {
+                continue;
+            }
+
+            if (log.indexOf(Call::Kind::Destroy, handle) > log.indexOf(Call::Kind::Destroy, dependency)) {
+                Si::Error("{} was destroyed after its dependency {}", handle->getName(), dependency->getName());
+                passed = false;
+            }
+
+            if (log.indexOf(Call::Kind::Create, handle) < log.indexOf(Call::Kind::Create, dependency)) {
+                Si::Error("{} was created before its dependency {}", handle->getName(), dependency->getName());
+                passed = false;
+            }
+        }
+
+        if (log.indexOf(Call::Kind::Create, handle) < log.indexOf(Call::Kind::Destroy, handle)) {
+            Si::Error("{} was created again before it was destroyed", handle->getName());
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    CallLog log;
+
+    // Shaped like a renderer: the framebuffer depends on both the swap chain and the render pass, and the command buffer a level below.
+    Stub device("device", log);
+    Stub swapChain("swapChain", log);
+    Stub renderPass("renderPass", log);
+    Stub framebuffer("framebuffer", log);
+    Stub pipeline("pipeline", log);
+    Stub commands("commands", log);
+
+    swapChain.dependOn(device);
+    renderPass.dependOn(device);
+    framebuffer.dependOn(swapChain);
+    framebuffer.dependOn(renderPass);
+    pipeline.dependOn(renderPass);
+    commands.dependOn(framebuffer);
+    commands.dependOn(pipeline);
+
+    std::vector<Stub *> handles {&device, &swapChain, &renderPass, &framebuffer, &pipeline, &commands};
+
+    commands.create();
+
+    if (!std::all_of(handles.begin(), handles.end(), [](Stub *handle) { return handle->isCreated(); })) {
+        Si::Error("Creating a handle did not create all of its dependencies");
+        return EXIT_FAILURE;
+    }
+
+    bool passed = true;
+
+    // Both roots at once: the framebuffer and command buffer they share are recreated once, not once for each root.
+    log.calls.clear();
+
+    std::array<Si::Vulkan::HandleBase *, 2> roots {&swapChain, &renderPass};
+    Si::Vulkan::HandleBase::recreate(roots);
+
+    passed &= ExpectRecreated(log, handles, {&swapChain, &renderPass, &framebuffer, &pipeline, &commands});
+
+    // A single root only recreates what depends on it.
+    log.calls.clear();
+    swapChain.create();
+
+    passed &= ExpectRecreated(log, handles, {&swapChain, &framebuffer, &commands});
+
+    // A root that depends on another root is still recreated after it.
+    log.calls.clear();
+
+    std::array<Si::Vulkan::HandleBase *, 2> nestedRoots {&framebuffer, &swapChain};
+    Si::Vulkan::HandleBase::recreate(nestedRoots);
+
+    passed &= ExpectRecreated(log, handles, {&swapChain, &framebuffer, &commands});
+
+    // Destroying only destroys, dependents first.
+    log.calls.clear();
+    device.destroy();
+
+    for (Stub *handle : handles) {
+        if (handle->isCreated() || (log.count(Call::Kind::Destroy, handle) != 1)) {
+            Si::Error("{} was not destroyed exactly once", handle->getName());
+            passed = false;
+        }
+
+        for (Stub *dependency : handle->getDependencies()) {
+            if (log.indexOf(Call::Kind::Destroy, handle) > log.indexOf(Call::Kind::Destroy, dependency)) {
+                Si::Error("{} was destroyed after its dependency {}", handle->getName(), dependency->getName());
+                passed = false;
+            }
+        }
+    }
+
+    Si::Deinitialize();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
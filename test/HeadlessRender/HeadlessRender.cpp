@@ -0,0 +1,137 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/26/23.
+//
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+#include "Silicon/Log.hpp"
+#include "Silicon/Renderer/Renderer.hpp"
+#include "Silicon/Renderer/VulkanRenderer.hpp"
+#include "Silicon/Silicon.hpp"
+
+namespace {
+
+// Reported to CTest when there is no Vulkan driver or device to render with, such as on CI runners.
+constexpr int SkipReturnCode = 77;
+
+constexpr std::uint32_t Width = 64;
+constexpr std::uint32_t Height = 64;
+
+using Pixel = std::array<std::uint8_t, 4>;
+
+Pixel GetPixel(Si::Span<const std::uint8_t> pixels, std::uint32_t x, std::uint32_t y)
+{
+    std::size_t offset = (std::size_t { y } * Width + x) * 4;
+    return { pixels[offset], pixels[offset + 1], pixels[offset + 2], pixels[offset + 3] };
+}
+
+bool ExpectPixel(Si::Span<const std::uint8_t> pixels, std::uint32_t x, std::uint32_t y, Pixel expected)
+{
+    Pixel pixel = GetPixel(pixels, x, y);
+
+    if (pixel != expected) {
+        Si::Error("Pixel ({}, {}) is ({}, {}, {}, {}), expected ({}, {}, {}, {})", x, y, pixel[0], pixel[1], pixel[2], pixel[3], expected[0], expected[1], expected[2], expected[3]);
+        return false;
+    }
+
+    return true;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    Si::VulkanRenderer::Initialize();
+    if (!Si::VulkanRenderer::CreateHeadless(Width, Height)) {
+        Si::Warn("No Vulkan device, skipping");
+        Si::VulkanRenderer::Deinitialize();
+        Si::Deinitialize();
+        return SkipReturnCode;
+    }
+
+    bool passed = true;
+
+    {
+        Si::Renderer *renderer = Si::Renderer::GetRenderer("Si::Vulkan::Headless");
+
+        if (!renderer) {
+            Si::Error("The headless renderer was not registered");
+            return EXIT_FAILURE;
+        }
+
+        // A white triangle, pointing up and wound clockwise so it is not culled.
+        const std::array<Si::Vertex, 3> vertices { {
+            { { 0.0f, -0.4f }, { 1.0f, 1.0f, 1.0f } },
+            { { 0.4f, 0.4f }, { 1.0f, 1.0f, 1.0f } },
+            { { -0.4f, 0.4f }, { 1.0f, 1.0f, 1.0f } },
+        } };
+
+        const std::array<std::uint32_t, 3> indices { 0, 1, 2 };
+
+        // Drawn twice, tinted red on the left and green on the right, leaving the middle cleared.
+        const std::array<Si::InstanceData, 2> instances { {
+            { { -0.5f, 0.0f }, { 1.0f, 0.0f, 0.0f } },
+            { { 0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+        } };
+
+        renderer->SetVertices(vertices);
+        renderer->SetIndices(indices);
+        renderer->SetInstances(instances);
+
+        if (!renderer->Draw()) {
+            Si::Error("Failed to draw");
+            return EXIT_FAILURE;
+        }
+
+        Si::Span<const std::uint8_t> pixels = renderer->GetPixels();
+
+        if (pixels.size() != std::size_t { Width } * Height * 4) {
+            Si::Error("Got {} bytes of pixels, expected {}", pixels.size(), std::size_t { Width } * Height * 4);
+            return EXIT_FAILURE;
+        }
+
+        // Rows are top first, and the top of the image is y = -1 in clip space.
+        passed &= ExpectPixel(pixels, Width / 4, Height / 2 + 3, { 255, 0, 0, 255 });
+        passed &= ExpectPixel(pixels, Width * 3 / 4, Height / 2 + 3, { 0, 255, 0, 255 });
+        passed &= ExpectPixel(pixels, Width / 2, Height / 2, { 0, 0, 0, 0 });
+        passed &= ExpectPixel(pixels, 0, 0, { 0, 0, 0, 0 });
+    }
+
+    Si::VulkanRenderer::Deinitialize();
+    Si::Deinitialize();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,183 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/22/23.
+//
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include "Silicon/Log.hpp"
+#include "Silicon/MemoryResource.hpp"
+#include "Silicon/Silicon.hpp"
+#include "Silicon/Types.hpp"
+
+namespace {
+
+bool IsAligned(const void *pointer, std::size_t alignment)
+{
+    return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+bool TestMonotonic()
+{
+    Si::TrackingResource upstream;
+
+    {
+        Si::InlineBufferResource<256> resource(&upstream);
+        Si::pmr::Vector<std::uint32_t> values(&resource);
+
+        for (std::uint32_t i = 0; i < 16; i++) {
+            values.push_back(i);
+        }
+
+        if (upstream.GetStats().totalAllocations != 0) {
+            Si::Error("Monotonic resource used the heap for a workload that fits its buffer");
+            return false;
+        }
+
+        for (std::uint32_t i = 16; i < 1000; i++) {
+            values.push_back(i);
+        }
+
+        if (!IsAligned(resource.Allocate(1, 256), 256) || values[999] != 999) {
+            Si::Error("Monotonic resource returned misaligned memory");
+            return false;
+        }
+
+        if (upstream.GetStats().liveAllocations == 0) {
+            Si::Error("Monotonic resource did not grow into its upstream resource");
+            return false;
+        }
+    }
+
+    if (upstream.GetStats().liveBytes != 0) {
+        Si::Error("Monotonic resource leaked {} bytes", upstream.GetStats().liveBytes);
+        return false;
+    }
+
+    return true;
+}
+
+bool TestPool()
+{
+    Si::TrackingResource upstream;
+    Si::UnsynchronizedPoolResource resource(&upstream);
+
+    void *first = resource.Allocate(24, 8);
+    resource.Deallocate(first, 24, 8);
+    void *second = resource.Allocate(32, 8);
+
+    void *aligned = resource.Allocate(64, 64);
+    void *large = resource.Allocate(Si::UnsynchronizedPoolResource::MaxPooledSize + 1);
+
+    if (first != second || !IsAligned(aligned, 64)) {
+        Si::Error("Pool resource did not reuse a freed block");
+        return false;
+    }
+
+    resource.Deallocate(large, Si::UnsynchronizedPoolResource::MaxPooledSize + 1);
+
+    {
+        Si::pmr::Map<int, std::string> map(&resource);
+
+        for (int i = 0; i < 1000; i++) {
+            map[i] = std::to_string(i);
+        }
+
+        Si::pmr::HashMap<std::string, int> hashMap(&resource);
+        hashMap["one"] = 1;
+
+        std::size_t chunks = upstream.GetStats().liveAllocations;
+
+        map.clear();
+
+        for (int i = 0; i < 1000; i++) {
+            map[i] = std::to_string(i);
+        }
+
+        if (upstream.GetStats().liveAllocations != chunks) {
+            Si::Error("Pool resource did not reuse the nodes of a cleared map");
+            return false;
+        }
+    }
+
+    resource.Release();
+
+    if (upstream.GetStats().liveBytes != 0) {
+        Si::Error("Pool resource leaked {} bytes", upstream.GetStats().liveBytes);
+        return false;
+    }
+
+    return true;
+}
+
+bool TestDefault()
+{
+    Si::TrackingResource tracking;
+    Si::MemoryResource *previous = Si::SetDefaultResource(&tracking);
+
+    {
+        Si::pmr::List<int> list;
+        list.push_back(1);
+
+        Si::pmr::List<int> copy(list, &tracking);
+
+        if (tracking.GetStats().liveAllocations != 2 || copy.get_allocator() != list.get_allocator()) {
+            Si::Error("Default resource was not used by a default constructed container");
+            return false;
+        }
+    }
+
+    Si::SetDefaultResource(previous);
+
+    Si::TrackingResource::Stats stats = tracking.GetStats();
+
+    if (stats.liveBytes != 0 || stats.peakBytes == 0 || stats.totalAllocations != 2) {
+        Si::Error("Tracking resource reported {} live and {} peak bytes", stats.liveBytes, stats.peakBytes);
+        return false;
+    }
+
+    return Si::GetDefaultResource() == Si::GetNewDeleteResource();
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    bool passed = TestMonotonic() && TestPool() && TestDefault();
+
+    Si::Deinitialize();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
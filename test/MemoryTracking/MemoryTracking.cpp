@@ -0,0 +1,144 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/23/23.
+//
+
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+
+#include "Silicon/Log.hpp"
+#include "Silicon/MemoryTracking.hpp"
+#include "Silicon/Node.hpp"
+#include "Silicon/Silicon.hpp"
+#include "Silicon/Types.hpp"
+
+namespace {
+
+class TestNode : public Si::Node
+{
+};
+
+std::int64_t LiveBytes(Si::MemoryTag tag)
+{
+    return Si::GetMemorySnapshot()[tag].liveBytes;
+}
+
+bool TestTagged()
+{
+    std::int64_t before = LiveBytes(Si::MemoryTag::Assets);
+    std::uint64_t totalBefore = Si::GetMemorySnapshot()[Si::MemoryTag::Assets].totalAllocations;
+
+    {
+        Si::Tagged<Si::MemoryTag::Assets>::Vector<std::uint32_t> values(1000);
+
+        if (LiveBytes(Si::MemoryTag::Assets) - before != 4000) {
+            Si::Error("Expected 4000 live asset bytes, found {}", LiveBytes(Si::MemoryTag::Assets) - before);
+            return false;
+        }
+    }
+
+    Si::MemoryTagStats stats = Si::GetMemorySnapshot()[Si::MemoryTag::Assets];
+
+    if (stats.liveBytes != before || stats.totalAllocations != totalBefore + 1 || stats.peakBytes < before + 4000) {
+        Si::Error("Asset accounting did not return to {} bytes after a free, found {}", before, stats.liveBytes);
+        return false;
+    }
+
+    return true;
+}
+
+bool TestThreads()
+{
+    constexpr std::size_t count = 10000;
+    std::int64_t before = LiveBytes(Si::MemoryTag::Events);
+
+    Si::Tagged<Si::MemoryTag::Events>::List<std::uint64_t> values;
+
+    // Allocate on one thread, large enough to cross the flush threshold, then free on another.
+    std::thread producer([&values]() {
+        for (std::uint64_t i = 0; i < count; i++) {
+            values.push_back(i);
+        }
+    });
+
+    producer.join();
+
+    std::int64_t allocated = LiveBytes(Si::MemoryTag::Events) - before;
+
+    if (allocated < static_cast<std::int64_t>(count * sizeof(std::uint64_t))) {
+        Si::Error("Expected the producer's allocations to be accounted, found {} bytes", allocated);
+        return false;
+    }
+
+    values.clear();
+
+    if (LiveBytes(Si::MemoryTag::Events) != before) {
+        Si::Error("Freeing on another thread left {} event bytes accounted", LiveBytes(Si::MemoryTag::Events) - before);
+        return false;
+    }
+
+    return true;
+}
+
+bool TestSubsystems()
+{
+    TestNode node;
+
+    Si::MemorySnapshot snapshot = Si::GetMemorySnapshot();
+
+    if (snapshot[Si::MemoryTag::Nodes].liveBytes <= 0 || snapshot[Si::MemoryTag::Logging].liveBytes <= 0) {
+        Si::Error("Nodes and logging were not accounted");
+        return false;
+    }
+
+    if (snapshot.getTotal().liveBytes < snapshot[Si::MemoryTag::Nodes].liveBytes) {
+        Si::Error("Total does not include every tag");
+        return false;
+    }
+
+    Si::LogMemorySnapshot();
+
+    return true;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    bool passed = TestTagged() && TestThreads() && TestSubsystems();
+
+    Si::Deinitialize();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
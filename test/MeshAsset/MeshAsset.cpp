@@ -0,0 +1,177 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/19/23.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Silicon/Log.hpp"
+#include "Silicon/MeshAsset.hpp"
+#include "Silicon/Silicon.hpp"
+
+namespace {
+
+std::string Base64(const std::vector<std::uint8_t> &bytes)
+{
+    static const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+
+    for (std::size_t i = 0; i < bytes.size(); i += 3) {
+        std::uint32_t chunk = bytes[i] << 16;
+        chunk |= i + 1 < bytes.size() ? bytes[i + 1] << 8 : 0;
+        chunk |= i + 2 < bytes.size() ? bytes[i + 2] : 0;
+
+        out += alphabet[(chunk >> 18) & 63];
+        out += alphabet[(chunk >> 12) & 63];
+        out += i + 1 < bytes.size() ? alphabet[(chunk >> 6) & 63] : '=';
+        out += i + 2 < bytes.size() ? alphabet[chunk & 63] : '=';
+    }
+
+    return out;
+}
+
+template <typename T>
+void Append(std::vector<std::uint8_t> &bytes, std::initializer_list<T> values)
+{
+    for (T value : values) {
+        std::uint8_t raw[sizeof(T)];
+        std::memcpy(raw, &value, sizeof(T));
+        bytes.insert(bytes.end(), raw, raw + sizeof(T));
+    }
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    // A quad with normalized byte colors and 16-bit indices, then an unindexed triangle.
+    std::vector<std::uint8_t> buffer;
+    Append<float>(buffer, {0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0});             // 0: quad positions, 48 bytes
+    Append<std::uint8_t>(buffer, {255, 0, 0, 255, 0, 255, 0, 255, 0, 0, 255, 255, 255, 255, 255, 255}); // 48: quad colors, 16 bytes
+    Append<std::uint16_t>(buffer, {0, 1, 2, 2, 3, 0});                        // 64: quad indices, 12 bytes
+    Append<std::uint16_t>(buffer, {0, 0});                                    // 76: padding
+    Append<float>(buffer, {-1, -1, 0, -2, -1, 0, -1, -2, 0});                 // 80: triangle positions, 36 bytes
+
+    std::string gltf = R"({
+        "asset": {"version": "2.0"},
+        "buffers": [{"byteLength": )" + std::to_string(buffer.size()) + R"(, "uri": "data:application/octet-stream;base64,)" + Base64(buffer) + R"("}],
+        "bufferViews": [
+            {"buffer": 0, "byteOffset": 0, "byteLength": 48},
+            {"buffer": 0, "byteOffset": 48, "byteLength": 16},
+            {"buffer": 0, "byteOffset": 64, "byteLength": 12},
+            {"buffer": 0, "byteOffset": 80, "byteLength": 36}
+        ],
+        "accessors": [
+            {"bufferView": 0, "componentType": 5126, "count": 4, "type": "VEC3"},
+            {"bufferView": 1, "componentType": 5121, "normalized": true, "count": 4, "type": "VEC4"},
+            {"bufferView": 2, "componentType": 5123, "count": 6, "type": "SCALAR"},
+            {"bufferView": 3, "componentType": 5126, "count": 3, "type": "VEC3"}
+        ],
+        "meshes": [
+            {"name": "Quad", "primitives": [{"attributes": {"POSITION": 0, "COLOR_0": 1}, "indices": 2}]},
+            {"name": "Triangle", "primitives": [{"attributes": {"POSITION": 3}}]}
+        ]
+    })";
+
+    const std::string path = "MeshAsset.gltf";
+    const std::string cookedPath = "MeshAsset.simesh";
+    std::ofstream(path) << gltf;
+
+    {
+        auto mesh = Si::Asset::GetNow<Si::MeshAsset>(path);
+
+        auto meshes = mesh->GetMeshes();
+        auto vertices = mesh->GetVertices();
+        auto indices = mesh->GetIndices();
+
+        if (meshes.size() != 2 || meshes[0].name != "Quad" || meshes[1].primitives.size() != 1 || vertices.size() != 7 || indices.size() != 9) {
+            Si::Error("Mesh has the wrong layout");
+            return EXIT_FAILURE;
+        }
+
+        const Si::MeshAsset::Primitive &triangle = meshes[1].primitives[0];
+
+        if (triangle.vertexOffset != 4 || triangle.vertexCount != 3 || triangle.firstIndex != 6 || triangle.indexCount != 3) {
+            Si::Error("Triangle primitive has the wrong ranges");
+            return EXIT_FAILURE;
+        }
+
+        const std::uint32_t expectedIndices[] = {0, 1, 2, 2, 3, 0, 0, 1, 2};
+        for (std::size_t i = 0; i < indices.size(); i++) {
+            if (indices[i] != expectedIndices[i]) {
+                Si::Error("Index {} is {}, expected {}", i, indices[i], expectedIndices[i]);
+                return EXIT_FAILURE;
+            }
+        }
+
+        if (vertices[2].position.x != 1 || vertices[2].position.y != 1 || vertices[1].color.x != 0 || vertices[1].color.y != 1 ||
+            vertices[2].color.z != 1 || vertices[5].position.x != -2 || vertices[6].color.x != 1) {
+            Si::Error("Vertices were decoded incorrectly");
+            return EXIT_FAILURE;
+        }
+
+        if (mesh->GetStagingBuffer().size() != mesh->GetIndexOffset() + indices.size() * sizeof(Si::MeshAsset::Index) ||
+            mesh->GetStagingBuffer().data() != reinterpret_cast<const std::uint8_t *>(vertices.data())) {
+            Si::Error("Staging buffer does not hold the vertices followed by the indices");
+            return EXIT_FAILURE;
+        }
+
+        if (!mesh->Cook(cookedPath)) {
+            return EXIT_FAILURE;
+        }
+
+        auto cooked = Si::Asset::GetNow<Si::MeshAsset>(cookedPath);
+        auto staging = mesh->GetStagingBuffer();
+        auto cookedStaging = cooked->GetStagingBuffer();
+
+        if (!std::equal(staging.begin(), staging.end(), cookedStaging.begin(), cookedStaging.end()) ||
+            cooked->GetIndexOffset() != mesh->GetIndexOffset() || cooked->GetMeshes().size() != 2 ||
+            cooked->GetMeshes()[1].name != "Triangle" || cooked->GetMeshes()[1].primitives[0].firstIndex != 6) {
+            Si::Error("Cooked mesh does not match the mesh it was cooked from");
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::remove(path.c_str());
+    std::remove(cookedPath.c_str());
+
+    Si::Deinitialize();
+
+    return EXIT_SUCCESS;
+}
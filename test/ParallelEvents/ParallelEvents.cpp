@@ -0,0 +1,176 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/13/23.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Silicon/Async.hpp"
+#include "Silicon/Event.hpp"
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+
+struct WorkerEvent
+{
+    int value;
+};
+
+struct FanOutEvent
+{
+    int value;
+};
+
+struct PinnedEvent
+{
+    int value;
+};
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    constexpr int producerCount = 4;
+    constexpr int eventsPerProducer = 1000;
+    constexpr int subscriberCount = 8;
+
+    bool success = true;
+
+    // Worker threads enqueue, the thread calling Si::Event::Process() receives.
+    {
+        Si::Event::Process();
+
+        std::thread::id mainThread = std::this_thread::get_id();
+        int received = 0;
+        bool wrongThread = false;
+
+        Si::Sub<WorkerEvent> sub([&](Si::Span<const WorkerEvent> events) {
+            received += static_cast<int>(events.size());
+            wrongThread |= std::this_thread::get_id() != mainThread;
+        });
+
+        std::vector<std::thread> producers;
+
+        for (int i = 0; i < producerCount; i++) {
+            producers.emplace_back([]() {
+                for (int j = 0; j < eventsPerProducer; j++) {
+                    Si::Enqueue(WorkerEvent {j});
+                }
+            });
+        }
+
+        for (std::thread &producer : producers) {
+            producer.join();
+        }
+
+        Si::Event::Process();
+
+        if ((received != producerCount * eventsPerProducer) || wrongThread) {
+            Si::Error("Received {} of {} events from worker threads", received, producerCount * eventsPerProducer);
+            success = false;
+        }
+    }
+
+    // Every subscriber runs on the async executor.
+    {
+        std::atomic<int> calls = 0;
+        std::vector<std::unique_ptr<Si::Sub<FanOutEvent>>> subs;
+
+        for (int i = 0; i < subscriberCount; i++) {
+            subs.push_back(std::make_unique<Si::Sub<FanOutEvent>>([&calls](const FanOutEvent &) {
+                calls++;
+            }));
+        }
+
+        Si::PubParallel(FanOutEvent {1});
+        Si::GetAsyncExecutor().wait_for_all();
+
+        if (calls != subscriberCount) {
+            Si::Error("{} of {} subscribers were called in parallel", calls.load(), subscriberCount);
+            success = false;
+        }
+    }
+
+    // Callbacks subscribe while the publishing thread destroys a subscriber, which waits for the callbacks to release their pin. The
+    // destructor must not hold the lock the callbacks need to subscribe while it waits.
+    {
+        std::atomic<bool> done = false;
+        std::mutex addedMutex;
+        std::vector<std::unique_ptr<Si::Sub<PinnedEvent>>> added;
+        std::vector<std::unique_ptr<Si::Sub<PinnedEvent>>> subs;
+
+        std::thread watchdog([&done]() {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+
+            while (!done) {
+                if (std::chrono::steady_clock::now() > deadline) {
+                    Si::Error("Subscribing from a parallel callback deadlocked with an unsubscribe");
+                    std::abort();
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        });
+
+        for (int i = 0; i < subscriberCount; i++) {
+            subs.push_back(std::make_unique<Si::Sub<PinnedEvent>>([&addedMutex, &added](const PinnedEvent &) {
+                // Give the publishing thread time to start destroying a subscriber.
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+                auto sub = std::make_unique<Si::Sub<PinnedEvent>>([](const PinnedEvent &) {});
+
+                std::lock_guard<std::mutex> lock(addedMutex);
+                added.push_back(std::move(sub));
+            }));
+        }
+
+        Si::PubParallel(PinnedEvent {1});
+        subs.pop_back();
+
+        Si::GetAsyncExecutor().wait_for_all();
+
+        done = true;
+        watchdog.join();
+
+        if (added.size() != subscriberCount) {
+            Si::Error("{} of {} parallel callbacks subscribed", added.size(), subscriberCount);
+            success = false;
+        }
+    }
+
+    Si::Deinitialize();
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,98 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/10/23.
+//
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+
+#include "Silicon/Log.hpp"
+#include "Silicon/Node.hpp"
+#include "Silicon/Silicon.hpp"
+
+class DepthNode : public Si::Node
+{
+public:
+    void update()
+    {
+        const auto *parent = dynamic_cast<const DepthNode *>(getParent());
+        depth = parent ? parent->depth + 1 : 0;
+    }
+
+    int depth = -1;
+};
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    constexpr std::size_t nodeCount = 100'000;
+    constexpr std::size_t fanOut = 4;
+
+    bool success = true;
+
+    {
+        auto nodes = std::make_unique<DepthNode[]>(nodeCount);
+        auto expectedDepths = std::make_unique<int[]>(nodeCount);
+        expectedDepths[0] = 0;
+
+        for (std::size_t i = 1; i < nodeCount; i++) {
+            nodes[(i - 1) / fanOut].addChild(nodes[i]);
+            expectedDepths[i] = expectedDepths[(i - 1) / fanOut] + 1;
+        }
+
+        std::atomic<std::size_t> visited = 0;
+
+        nodes[0].parallelTraverse([&visited](Si::Node &node) {
+            // Depths can only be right if every parent is updated before its children.
+            static_cast<DepthNode &>(node).update();
+            visited++;
+        }, 256);
+
+        if (visited != nodeCount) {
+            Si::Error("Visited {} nodes, expected {}", visited.load(), nodeCount);
+            success = false;
+        }
+
+        for (std::size_t i = 0; i < nodeCount; i++) {
+            if (nodes[i].depth != expectedDepths[i]) {
+                Si::Error("Node {} has depth {}, expected {}", i, nodes[i].depth, expectedDepths[i]);
+                success = false;
+                break;
+            }
+        }
+    }
+
+    Si::Deinitialize();
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,162 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/26/23.
+//
+
+#include <cstdlib>
+
+#include "Silicon/Log.hpp"
+#include "Silicon/Silicon.hpp"
+
+#include "vulkan/Device.hpp"
+#include "vulkan/Instance.hpp"
+#include "vulkan/PhysicalDevice.hpp"
+#include "vulkan/PipelineCache.hpp"
+#include "vulkan/RenderPass.hpp"
+
+namespace {
+
+// Reported to CTest when there is no Vulkan driver or device to build pipelines with, such as on CI runners.
+constexpr int SkipReturnCode = 77;
+
+const char *VertexShader = R"(#version 450
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec3 inColor;
+layout(location = 2) in vec2 inInstanceOffset;
+layout(location = 3) in vec3 inInstanceTint;
+layout(location = 0) out vec3 fragColor;
+
+void main() {
+    gl_Position = vec4(inPosition + inInstanceOffset, 0.0, 1.0);
+    fragColor = inColor * inInstanceTint;
+})";
+
+const char *FragmentShader = R"(#version 450
+layout(location = 0) in vec3 fragColor;
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = vec4(fragColor, 1.0);
+})";
+
+bool HasDevice(Si::Vulkan::Instance &instance)
+{
+    try {
+        return !instance->enumeratePhysicalDevices().empty();
+    } catch (const vk::SystemError &error) {
+        Si::Warn("Failed to create a Vulkan instance: {}", error.what());
+        return false;
+    }
+}
+
+bool ExpectStats(const Si::Vulkan::PipelineCache &cache, std::uint64_t hits, std::uint64_t misses)
+{
+    Si::Vulkan::PipelineCache::Stats stats = cache.getStats();
+
+    if ((stats.hits != hits) || (stats.misses != misses)) {
+        Si::Error("Cache has {} hits and {} misses, expected {} and {}", stats.hits, stats.misses, hits, misses);
+        return false;
+    }
+
+    return true;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    if (!Si::Initialize()) {
+        return EXIT_FAILURE;
+    }
+
+    Si::Vulkan::Instance instance(true);
+
+    if (!HasDevice(instance)) {
+        Si::Warn("No Vulkan device, skipping");
+        Si::Deinitialize();
+        return SkipReturnCode;
+    }
+
+    Si::Vulkan::PhysicalDevice physicalDevice = *Si::Vulkan::PhysicalDevice::getBest(instance, nullptr, { { "VK_KHR_portability_subset", false } });
+    Si::Vulkan::Device device(physicalDevice);
+    Si::Vulkan::RenderPass renderPass(device, vk::Format::eR8G8B8A8Unorm, vk::ImageLayout::eTransferSrcOptimal);
+
+    bool passed = true;
+
+    {
+        Si::Vulkan::PipelineCache cache(device);
+
+        Si::Vulkan::PipelineDescription description;
+        description.renderPass = &renderPass;
+        description.stages.push_back({ Si::Vulkan::Shader::Type::Vertex, Si::Vulkan::Shader::compile(VertexShader, Si::Vulkan::Shader::Type::Vertex) });
+        description.stages.push_back({ Si::Vulkan::Shader::Type::Fragment, Si::Vulkan::Shader::compile(FragmentShader, Si::Vulkan::Shader::Type::Fragment) });
+
+        // An identical description, built separately, must find the pipeline the first one started building.
+        Si::Vulkan::PipelineDescription identical = description;
+
+        Si::Vulkan::PipelineCache::Id first = cache.request(description);
+        Si::Vulkan::PipelineCache::Id second = cache.request(identical);
+
+        if (first != second) {
+            Si::Error("Identical descriptions got different ids {} and {}", first, second);
+            passed = false;
+        }
+
+        passed &= ExpectStats(cache, 1, 1);
+
+        Si::Vulkan::PipelineDescription changed = description;
+        changed.cullMode = vk::CullModeFlagBits::eNone;
+
+        Si::Vulkan::PipelineCache::Id third = cache.request(changed);
+
+        if (third == first) {
+            Si::Error("A description with a different cull mode got the same id {}", third);
+            passed = false;
+        }
+
+        passed &= ExpectStats(cache, 1, 2);
+
+        vk::Pipeline firstPipeline = cache.wait(first);
+        vk::Pipeline thirdPipeline = cache.wait(third);
+
+        if (!firstPipeline || !thirdPipeline || (firstPipeline == thirdPipeline)) {
+            Si::Error("Expected two distinct pipelines to be built");
+            passed = false;
+        }
+
+        if (cache.get(second) != firstPipeline) {
+            Si::Error("Looking up the second id did not return the first pipeline");
+            passed = false;
+        }
+    }
+
+    Si::Deinitialize();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
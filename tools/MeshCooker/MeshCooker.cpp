@@ -0,0 +1,66 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/20/23.
+//
+
+#include <cstdlib>
+#include <exception>
+
+#include "Silicon/Log.hpp"
+#include "Silicon/MeshAsset.hpp"
+
+/*
+ * Cooks a glTF or GLB model into Silicon's binary mesh layout.
+ *
+ * Usage: SiliconMeshCooker <model> <cooked mesh>
+ */
+int main(int argc, char **argv)
+{
+    if (argc != 3) {
+        Si::Error("Usage: {} <model> <cooked mesh>", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    try {
+        auto mesh = Si::Asset::GetNow<Si::MeshAsset>(argv[1]);
+
+        if (!mesh->Cook(argv[2])) {
+            return EXIT_FAILURE;
+        }
+
+        Si::Info("Cooked {} into {}: {} vertices, {} indices", argv[1], argv[2], mesh->GetVertices().size(), mesh->GetIndices().size());
+    } catch (const std::exception &) {
+        // Already logged by the loader.
+        return EXIT_FAILURE;
+    }
+
+    Si::Asset::Shutdown();
+
+    return EXIT_SUCCESS;
+}
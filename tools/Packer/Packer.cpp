@@ -0,0 +1,83 @@
+// BSD 2-Clause License
+//
+// Copyright (c) 2023, Matthew McCall
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this
+//    list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+// FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+// DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+// SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+// CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+// OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+//
+// Created by Matthew McCall on 1/17/23.
+//
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "Silicon/Archive.hpp"
+#include "Silicon/Log.hpp"
+
+/*
+ * Packs files into a Silicon archive. Each file is stored under the path it was given on the command line.
+ *
+ * Usage: SiliconPacker [--compress] <archive> <files...>
+ */
+int main(int argc, char **argv)
+{
+    int arg = 1;
+    auto compression = Si::Archive::Compression::None;
+
+    if (arg < argc && std::string(argv[arg]) == "--compress") {
+        compression = Si::Archive::Compression::LZ;
+        arg++;
+    }
+
+    if (argc - arg < 1) {
+        Si::Error("Usage: {} [--compress] <archive> <files...>", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::string output = argv[arg++];
+    Si::ArchiveWriter writer;
+    int packed = 0;
+
+    for (; arg < argc; arg++) {
+        std::ifstream file(argv[arg], std::ios::binary);
+        if (!file) {
+            Si::Error("Failed to open {}", argv[arg]);
+            return EXIT_FAILURE;
+        }
+
+        Si::Vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        writer.Add(argv[arg], Si::Span<const std::uint8_t>(bytes.data(), bytes.size()), compression);
+        packed++;
+    }
+
+    if (!writer.Write(output)) {
+        return EXIT_FAILURE;
+    }
+
+    Si::Info("Packed {} files into {}", packed, output);
+
+    return EXIT_SUCCESS;
+}